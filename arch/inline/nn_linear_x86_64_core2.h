@@ -324,6 +324,116 @@ word_t nn_neg_c(nn_t a, nn_src_t b, len_t m, word_t ci)
 
 #endif
 
+#ifndef HAVE_ARCH_nn_cnd_add
+#define HAVE_ARCH_nn_cnd_add
+
+word_t nn_cnd_add(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd)
+{
+   word_t ci = 0;
+   
+   cnd = nn_cnd_mask(cnd);
+
+   __asm__ __volatile__ (
+
+   "jrcxz 2f; \
+    leaq (%%rdi,%%rcx,8), %%rdi; \
+    leaq (%%rsi,%%rcx,8), %%rsi; \
+    leaq (%%rdx,%%rcx,8), %%rdx; \
+    neg %%rcx; \
+1:; \
+    movq (%%rdx,%%rcx,8), %%r10; \
+    andq %[mask], %%r10; \
+    btl $0, %%eax; \
+    adcq (%%rsi,%%rcx,8), %%r10; \
+    movq %%r10, (%%rdi,%%rcx,8); \
+    setc %%al; \
+    incq %%rcx; \
+    jnz 1b; \
+2:;"
+
+   : "+a" (ci), "+c" (m), "+d" (c), "+S" (b), "+D" (a)
+   : [mask] "r" (cnd)
+   : "r10", "cc", "memory"
+   );
+
+   return ci;
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_cnd_sub
+#define HAVE_ARCH_nn_cnd_sub
+
+word_t nn_cnd_sub(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd)
+{
+   word_t bi = 0;
+   
+   cnd = nn_cnd_mask(cnd);
+
+   __asm__ __volatile__ (
+
+   "jrcxz 2f; \
+    leaq (%%rdi,%%rcx,8), %%rdi; \
+    leaq (%%rsi,%%rcx,8), %%rsi; \
+    leaq (%%rdx,%%rcx,8), %%rdx; \
+    neg %%rcx; \
+1:; \
+    movq (%%rdx,%%rcx,8), %%r10; \
+    movq (%%rsi,%%rcx,8), %%r11; \
+    andq %[mask], %%r10; \
+    btl $0, %%eax; \
+    sbbq %%r10, %%r11; \
+    movq %%r11, (%%rdi,%%rcx,8); \
+    setc %%al; \
+    incq %%rcx; \
+    jnz 1b; \
+2:;"
+
+   : "+a" (bi), "+c" (m), "+d" (c), "+S" (b), "+D" (a)
+   : [mask] "r" (cnd)
+   : "r10", "r11", "cc", "memory"
+   );
+
+   return bi;
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_cnd_swap
+#define HAVE_ARCH_nn_cnd_swap
+
+void nn_cnd_swap(nn_t a, nn_t b, len_t m, word_t cnd)
+{
+   cnd = nn_cnd_mask(cnd);
+
+   __asm__ __volatile__ (
+
+   "jrcxz 2f; \
+    leaq (%%rdi,%%rcx,8), %%rdi; \
+    leaq (%%rsi,%%rcx,8), %%rsi; \
+    neg %%rcx; \
+1:; \
+    movq (%%rdi,%%rcx,8), %%r10; \
+    movq (%%rsi,%%rcx,8), %%r11; \
+    movq %%r10, %%r9; \
+    xorq %%r11, %%r9; \
+    andq %[mask], %%r9; \
+    xorq %%r9, %%r10; \
+    xorq %%r9, %%r11; \
+    movq %%r10, (%%rdi,%%rcx,8); \
+    movq %%r11, (%%rsi,%%rcx,8); \
+    incq %%rcx; \
+    jnz 1b; \
+2:;"
+
+   : "+c" (m), "+S" (b), "+D" (a)
+   : [mask] "r" (cnd)
+   : "r9", "r10", "r11", "cc", "memory"
+   );
+}
+
+#endif
+
 #ifdef __cplusplus
  }
 #endif
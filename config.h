@@ -0,0 +1,6 @@
+#define WANT_ASSERT 0
+#define WANT_REDZONES 1
+#define WANT_THREADS 0
+#define IS_LITTLE_ENDIAN 0x10
+#define IS_BIG_ENDIAN 0x20
+#define PLATFORM_BYTE_ORDER IS_LITTLE_ENDIAN
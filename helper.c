@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include "helper.h"
 #include "helper_arch.h"
 #include "nn.h"
@@ -221,3 +222,253 @@ preinv2_t precompute_inverse2(word_t d1, word_t d2)
 }
 
 #endif
+
+#ifndef HAVE_ARCH_invmod1_binary
+
+/* set x = x/2 mod d, for odd d, without overflowing a word */
+#define __half_mod(x, d) \
+   do { \
+      if ((x) & 1) (x) = ((x) >> 1) + ((d) >> 1) + 1; \
+      else (x) >>= 1; \
+   } while (0)
+
+word_t invmod1_binary(word_t a, word_t d)
+{
+   word_t u = a, v = d, x1 = 1, x2 = 0;
+
+   ASSERT(d & 1);
+   ASSERT(d > 1);
+   ASSERT(a < d);
+
+   if (a == 0)
+      return 0;
+
+   /* invariants: x1*a = u mod d and x2*a = v mod d */
+   while (u != 1 && v != 1)
+   {
+      while ((u & 1) == 0)
+      {
+         u >>= 1;
+         __half_mod(x1, d);
+      }
+
+      while ((v & 1) == 0)
+      {
+         v >>= 1;
+         __half_mod(x2, d);
+      }
+
+      if (u >= v)
+      {
+         u -= v;
+         x1 = x1 >= x2 ? x1 - x2 : x1 + (d - x2);
+      } else
+      {
+         v -= u;
+         x2 = x2 >= x1 ? x2 - x1 : x2 + (d - x1);
+      }
+
+      if (u == 0) /* gcd(a, d) = v > 1 */
+         return 0;
+   }
+
+   return u == 1 ? x1 : x2;
+}
+
+#undef __half_mod
+
+#endif
+
+word_t n_sqrtrem(word_t * r, word_t a)
+{
+   const word_t max = (WORD(1) << (WORD_BITS/2)) - 1;
+   word_t s = (word_t) sqrt((double) a);
+
+   /* the double is accurate to a few units, correct it */
+   if (s > max)
+      s = max;
+
+   while (s*s > a)
+      s--;
+
+   while (s < max && (s + 1)*(s + 1) <= a)
+      s++;
+
+   if (r != NULL)
+      (*r) = a - s*s;
+
+   return s;
+}
+
+int n_jacobi(word_t a, word_t n)
+{
+   word_t t;
+   int s = 1;
+
+   ASSERT(n & 1);
+
+   a %= n;
+
+   while (a != 0)
+   {
+      /* (2/n) = -1 iff n = 3, 5 mod 8 */
+      while ((a & 1) == 0)
+      {
+         a >>= 1;
+         if ((n & 7) == 3 || (n & 7) == 5)
+            s = -s;
+      }
+
+      /* quadratic reciprocity */
+      t = a; a = n; n = t;
+      if ((a & 3) == 3 && (n & 3) == 3)
+         s = -s;
+
+      a %= n;
+   }
+
+   return n == 1 ? s : 0;
+}
+
+/*
+   Return a*b mod d, where a, b < d, and dn = d << norm is normalised 
+   with precomputed inverse dinv.
+*/
+static inline
+word_t _n_mulmod_preinv(word_t a, word_t b, word_t dn, 
+                                          preinv1_t dinv, int norm)
+{
+   const dword_t t = (dword_t) a * (dword_t) (b << norm);
+   word_t q, r;
+
+   divrem21_preinv1(q, r, (word_t) (t >> WORD_BITS), (word_t) t, dn, dinv);
+   (void) q;
+
+   return r >> norm;
+}
+
+/* 
+   Return (a - b) mod d and (a + b) mod d, where a, b < d.
+*/
+#define __sub_mod(a, b, d) \
+   ((a) >= (b) ? (a) - (b) : (a) + ((d) - (b)))
+
+#define __add_mod(a, b, d) \
+   ((a) >= (d) - (b) ? (a) - ((d) - (b)) : (a) + (b))
+
+/* odd primes up to 53 for trial division */
+static const word_t _n_small_primes[15] = 
+   { 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+
+int n_is_prime(word_t n)
+{
+   word_t d, x, v0, v1, qk, qk1, qm, dn;
+   preinv1_t dinv;
+   sword_t D;
+   long i, s;
+   int j, norm;
+
+   if (n < 4)
+      return n >= 2;
+
+   if ((n & 1) == 0)
+      return 0;
+
+   for (i = 0; i < 15; i++)
+   {
+      if (n == _n_small_primes[i])
+         return 1;
+      if (n % _n_small_primes[i] == 0)
+         return 0;
+   }
+
+   if (n < 59*59)
+      return 1;
+
+   /* n is now large enough to normalise and invert */
+   norm = high_zero_bits(n);
+   dn = n << norm;
+   dinv = precompute_inverse1(dn);
+
+   /* strong Fermat test to base 2, with n - 1 = d*2^s */
+   s = low_zero_bits(n - 1);
+   d = (n - 1) >> s;
+
+   for (x = 1, i = WORD_BITS - high_zero_bits(d) - 1; i >= 0; i--)
+   {
+      x = _n_mulmod_preinv(x, x, dn, dinv, norm);
+      if ((d >> i) & 1)
+         x = __add_mod(x, x, n);
+   }
+
+   if (x != 1 && x != n - 1)
+   {
+      for (i = 1; i < s && x != n - 1; i++)
+         x = _n_mulmod_preinv(x, x, dn, dinv, norm);
+      
+      if (x != n - 1)
+         return 0;
+   }
+
+   /* no D below has (D/n) = -1 if n is a square */
+   if (n_sqrt(n)*n_sqrt(n) == n)
+      return 0;
+
+   /* Selfridge's choice of D in 5, -7, 9, -11, ... with (D/n) = -1 */
+   for (D = 5; ; D = (D > 0 ? -D - 2 : -D + 2))
+   {
+      j = n_jacobi(D > 0 ? (word_t) D : n - (word_t) -D, n);
+      if (j == -1)
+         break;
+      if (j == 0) /* |D| < n shares a factor with n */
+         return 0;
+   }
+
+   /* Q = (1 - D)/4 mod n, P = 1 */
+   qm = (D > 0 ? n - (word_t) (D - 1)/4 : (word_t) (1 - D)/4);
+
+   /* strong Lucas test, with n + 1 = d*2^s */
+   s = low_zero_bits(n + 1);
+   d = (n + 1) >> s;
+
+   /* (v0, v1, qk) = (V_k, V_{k + 1}, Q^k), starting with k = 0 */
+   v0 = 2;
+   v1 = 1;
+   qk = 1;
+   for (i = WORD_BITS - high_zero_bits(d) - 1; i >= 0; i--)
+   {
+      if ((d >> i) & 1) /* k -> 2k + 1 */
+      {
+         v0 = __sub_mod(_n_mulmod_preinv(v0, v1, dn, dinv, norm), qk, n);
+         qk1 = _n_mulmod_preinv(qk, qm, dn, dinv, norm);
+         v1 = _n_mulmod_preinv(v1, v1, dn, dinv, norm);
+         v1 = __sub_mod(v1, __add_mod(qk1, qk1, n), n);
+         qk = _n_mulmod_preinv(qk, qk1, dn, dinv, norm);
+      } else /* k -> 2k */
+      {
+         v1 = __sub_mod(_n_mulmod_preinv(v0, v1, dn, dinv, norm), qk, n);
+         v0 = _n_mulmod_preinv(v0, v0, dn, dinv, norm);
+         v0 = __sub_mod(v0, __add_mod(qk, qk, n), n);
+         qk = _n_mulmod_preinv(qk, qk, dn, dinv, norm);
+      }
+   }
+
+   /* D*U_d = 2V_{d + 1} - V_d */
+   if (__add_mod(v1, v1, n) == v0)
+      return 1;
+
+   for (i = 0; i < s; i++)
+   {
+      if (v0 == 0)
+         return 1;
+
+      v0 = _n_mulmod_preinv(v0, v0, dn, dinv, norm);
+      v0 = __sub_mod(v0, __add_mod(qk, qk, n), n);
+      qk = _n_mulmod_preinv(qk, qk, dn, dinv, norm);
+   }
+
+   return 0;
+}
+
+#undef __sub_mod
+#undef __add_mod
@@ -169,6 +169,14 @@ void talker(const char * str);
 
 #define high_zero_bits __builtin_clzl
 
+#define low_zero_bits __builtin_ctzl
+
+#if WORD_BITS == 64
+#define byte_swap __builtin_bswap64
+#else
+#define byte_swap __builtin_bswap32
+#endif
+
 #endif
 
 #ifndef HAVE_ARCH_divapprox21_preinv1
@@ -321,6 +329,40 @@ void precompute_hensel_inverse1(hensel_preinv1_t * inv, word_t d)
 
 #endif
 
+/*
+   Return the inverse of a modulo the odd word d, computed by the binary
+   extended Euclidean algorithm, or 0 if a is not invertible modulo d.
+   We require d > 1 and a < d.
+*/
+word_t invmod1_binary(word_t a, word_t d);
+
+/*
+   Return the integer square root s = floor(sqrt(a)) of the word a, and
+   if r is not NULL set *r = a - s^2. A double precision square root 
+   is corrected by at most a few steps.
+*/
+word_t n_sqrtrem(word_t * r, word_t a);
+
+/*
+   Return the integer square root floor(sqrt(a)) of the word a.
+*/
+#define n_sqrt(a) \
+   n_sqrtrem(NULL, a)
+
+/*
+   Return the Jacobi symbol (a/n) for odd n.
+*/
+int n_jacobi(word_t a, word_t n);
+
+/*
+   Return 1 if the word n is prime, otherwise 0. After trial division by
+   the primes up to 53, a strong Fermat test to base 2 and a strong 
+   Lucas test with Selfridge's parameters (the BPSW test) are applied,
+   with products reduced by divrem21_preinv1. No composite passes both
+   below 2^64, so the result is exact.
+*/
+int n_is_prime(word_t n);
+
 /**********************************************************************
  
     Printing functions
@@ -0,0 +1,144 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "nmod.h"
+
+word_t n_powmod(word_t a, word_t e, nmod_t mod)
+{
+   word_t r = mod.n == 1 ? 0 : 1;
+
+   ASSERT(a < mod.n);
+
+   while (e != 0)
+   {
+      if (e & 1)
+         r = n_mulmod_preinv(r, a, mod);
+      
+      e >>= 1;
+      
+      if (e != 0)
+         a = n_mulmod_preinv(a, a, mod);
+   }
+
+   return r;
+}
+
+word_t n_invmod(word_t a, nmod_t mod)
+{
+   word_t r0 = mod.n, r1 = a, s0 = 0, s1 = 1, q, t;
+   int neg = 0;
+
+   ASSERT(a < mod.n);
+
+   if ((mod.n & 1) && mod.n != 1)
+      return invmod1_binary(a, mod.n);
+
+   /* invariant: r1 = (-1)^neg * s1 * a mod n */
+   while (r1 > 1)
+   {
+      q = r0 / r1;
+      
+      t = r0 - q*r1;
+      r0 = r1;
+      r1 = t;
+
+      t = s0 + q*s1;
+      s0 = s1;
+      s1 = t;
+      
+      neg = !neg;
+   }
+
+   if (r1 == 0) /* gcd(a, n) = r0 */
+      return 0;
+
+   return neg ? mod.n - s1 : s1;
+}
+
+void nmod_vec_add(nn_t r, nn_src_t a, nn_src_t b, len_t len, nmod_t mod)
+{
+   len_t i;
+
+   for (i = 0; i < len; i++)
+      r[i] = n_addmod(a[i], b[i], mod);
+}
+
+void nmod_vec_sub(nn_t r, nn_src_t a, nn_src_t b, len_t len, nmod_t mod)
+{
+   len_t i;
+
+   for (i = 0; i < len; i++)
+      r[i] = n_submod(a[i], b[i], mod);
+}
+
+void nmod_vec_neg(nn_t r, nn_src_t a, len_t len, nmod_t mod)
+{
+   len_t i;
+
+   for (i = 0; i < len; i++)
+      r[i] = n_negmod(a[i], mod);
+}
+
+void nmod_vec_scalar_mul(nn_t r, nn_src_t a, len_t len, 
+                                                   word_t c, nmod_t mod)
+{
+   word_t cpre;
+   len_t i;
+
+   ASSERT(c < mod.n);
+
+   if ((mod.n >> (WORD_BITS - 1)) == 0)
+   {
+      cpre = n_mulmod_shoup_precomp(c, mod);
+
+      for (i = 0; i < len; i++)
+         r[i] = n_mulmod_shoup(a[i], c, cpre, mod);
+   } else
+   {
+      for (i = 0; i < len; i++)
+         r[i] = n_mulmod_preinv(a[i], c, mod);
+   }
+}
+
+word_t nmod_vec_dot(nn_src_t a, nn_src_t b, len_t len, nmod_t mod)
+{
+   dword_t s = 0, p;
+   word_t hi = 0, r;
+   len_t i;
+
+   for (i = 0; i < len; i++)
+   {
+      p = (dword_t) a[i] * (dword_t) b[i];
+      s += p;
+      hi += (s < p);
+   }
+
+   r = n_mod2_preinv(0, hi, mod);
+   r = n_mod2_preinv(r, (word_t) (s >> WORD_BITS), mod);
+   
+   return n_mod2_preinv(r, (word_t) s, mod);
+}
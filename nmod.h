@@ -0,0 +1,229 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BSDNT_NMOD_H
+#define BSDNT_NMOD_H
+
+#include "helper.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+   A word sized modulus n along with precomputed data for fast 
+   reduction modulo n.
+*/
+typedef struct
+{
+   word_t n;       /* the modulus */
+   preinv1_t ninv; /* precomputed inverse of n << norm */
+   bits_t norm;    /* number of leading zero bits of n */
+} nmod_t;
+
+/**********************************************************************
+ 
+    Initialisation
+
+**********************************************************************/
+
+/*
+   Initialise mod for reduction modulo the nonzero word n.
+*/
+static inline
+void nmod_init(nmod_t * mod, word_t n)
+{
+   ASSERT(n != 0);
+
+   mod->n = n;
+   mod->norm = high_zero_bits(n);
+   mod->ninv = precompute_inverse1(n << mod->norm);
+}
+
+/**********************************************************************
+ 
+    Single word modular arithmetic
+
+**********************************************************************/
+
+/*
+   Return {lo, hi} modulo n. We require hi < n.
+*/
+static inline
+word_t n_mod2_preinv(word_t hi, word_t lo, nmod_t mod)
+{
+   word_t q, r;
+
+   ASSERT(hi < mod.n);
+
+   if (mod.norm)
+   {
+      hi = (hi << mod.norm) + (lo >> (WORD_BITS - mod.norm));
+      lo <<= mod.norm;
+   }
+
+   divrem21_preinv1(q, r, hi, lo, mod.n << mod.norm, mod.ninv);
+   (void) q;
+
+   return r >> mod.norm;
+}
+
+/*
+   Return a + b modulo n. We require a, b < n.
+*/
+static inline
+word_t n_addmod(word_t a, word_t b, nmod_t mod)
+{
+   word_t d = mod.n - b;
+
+   return a - d + (mod.n & -(word_t) (a < d));
+}
+
+/*
+   Return a - b modulo n. We require a, b < n.
+*/
+static inline
+word_t n_submod(word_t a, word_t b, nmod_t mod)
+{
+   return a - b + (mod.n & -(word_t) (a < b));
+}
+
+/*
+   Return -a modulo n. We require a < n.
+*/
+static inline
+word_t n_negmod(word_t a, nmod_t mod)
+{
+   return n_submod(0, a, mod);
+}
+
+/*
+   Return a*b modulo n. We require a, b < n.
+*/
+static inline
+word_t n_mulmod_preinv(word_t a, word_t b, nmod_t mod)
+{
+   dword_t p = (dword_t) a * (dword_t) b;
+
+   return n_mod2_preinv((word_t) (p >> WORD_BITS), (word_t) p, mod);
+}
+
+/*
+   Return a^e modulo n. We require a < n. By convention 0^0 = 1, 
+   except when n = 1.
+*/
+word_t n_powmod(word_t a, word_t e, nmod_t mod);
+
+/*
+   Return the inverse of a modulo n, or 0 if a is not invertible 
+   modulo n. We require a < n. Odd moduli use a binary extended gcd
+   and even moduli the ordinary extended Euclidean algorithm.
+*/
+word_t n_invmod(word_t a, nmod_t mod);
+
+/**********************************************************************
+ 
+    Shoup multiplication
+
+**********************************************************************/
+
+/*
+   Return floor(b*B/n), for use as the precomputed value bpre in 
+   n_mulmod_shoup. We require b < n.
+*/
+static inline
+word_t n_mulmod_shoup_precomp(word_t b, nmod_t mod)
+{
+   ASSERT(b < mod.n);
+
+   return (word_t) ((((dword_t) b) << WORD_BITS) / (dword_t) mod.n);
+}
+
+/*
+   Return a*b modulo n, given bpre = n_mulmod_shoup_precomp(b, mod).
+   This needs only two word multiplications and a single correction,
+   and is therefore cheaper than n_mulmod_preinv when b is reused.
+   We require b < n < B/2, but a can be any word.
+*/
+static inline
+word_t n_mulmod_shoup(word_t a, word_t b, word_t bpre, nmod_t mod)
+{
+   word_t q = (word_t) (((dword_t) a * (dword_t) bpre) >> WORD_BITS);
+   word_t r = a*b - q*mod.n;
+
+   ASSERT(mod.n >> (WORD_BITS - 1) == 0);
+
+   return r - (mod.n & -(word_t) (r >= mod.n));
+}
+
+/**********************************************************************
+ 
+    Vector functions
+
+**********************************************************************/
+
+/*
+   The following functions operate on vectors of len words, each 
+   reduced modulo n. The loops are branch free, so that the compiler
+   can vectorise them where the instruction set permits. The output
+   may alias any of the inputs.
+*/
+
+/*
+   Set r[i] = a[i] + b[i] modulo n for 0 <= i < len.
+*/
+void nmod_vec_add(nn_t r, nn_src_t a, nn_src_t b, len_t len, nmod_t mod);
+
+/*
+   Set r[i] = a[i] - b[i] modulo n for 0 <= i < len.
+*/
+void nmod_vec_sub(nn_t r, nn_src_t a, nn_src_t b, len_t len, nmod_t mod);
+
+/*
+   Set r[i] = -a[i] modulo n for 0 <= i < len.
+*/
+void nmod_vec_neg(nn_t r, nn_src_t a, len_t len, nmod_t mod);
+
+/*
+   Set r[i] = c*a[i] modulo n for 0 <= i < len. We require c < n.
+   Shoup multiplication is used when n < B/2.
+*/
+void nmod_vec_scalar_mul(nn_t r, nn_src_t a, len_t len, 
+                                                  word_t c, nmod_t mod);
+
+/*
+   Return the sum of a[i]*b[i] for 0 <= i < len, modulo n. The 
+   products are accumulated in three words, so that only a single 
+   reduction is required at the end.
+*/
+word_t nmod_vec_dot(nn_src_t a, nn_src_t b, len_t len, nmod_t mod);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
@@ -25,12 +25,225 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <math.h>
+#include <string.h>
 #include "nn.h"
 #include "nn_arch.h"
 
+size_t nn_sizeinbase(nn_src_t a, len_t m, int base)
+{
+   bits_t bits;
+
+   ASSERT(base >= 2 && base <= 62);
+
+   while (m > 0 && a[m - 1] == 0)
+      m--;
+
+   if (m == 0)
+      return 1;
+
+   bits = m*WORD_BITS - high_zero_bits(a[m - 1]);
+
+   if ((base & (base - 1)) == 0) /* power of 2, exact */
+      return (bits + low_zero_bits(base) - 1)/low_zero_bits(base);
+
+   /* a < 2^bits, so it has at most ceil(bits*log_base(2)) digits */
+   return (size_t) (bits/log2(base)) + 1;
+}
+
+/*
+   As per nn_get_str_buf, but using up to the given number of threads.
+*/
+static
+size_t _nn_get_str_buf(char * buf, size_t cap, 
+                                 nn_src_t a, len_t m, long threads)
+{
+   size_t i, digits = nn_sizeinbase(a, m, 10);
+   nn_t t;
+   TMP_INIT;
+
+   if (cap <= digits)
+      return 0;
+
+   while (m > 0 && a[m - 1] == 0)
+      m--;
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(m);
+   nn_copy(t, a, m);
+
+   if (m < GET_STR_DIVCONQUER_CUTOFF)
+      nn_get_str_classical(buf, digits, t, m);
+#if WANT_THREADS
+   else if (threads > 1)
+      nn_get_str_divconquer_threaded(buf, digits, t, m, threads);
+#endif
+   else
+      nn_get_str_divconquer(buf, digits, t, m);
+
+   TMP_END;
+
+   /* the size estimate may be one too large */
+   for (i = 0; i < digits - 1 && buf[i] == '0'; i++) ;
+   
+   if (i)
+      memmove(buf, buf + i, digits - i);
+
+   buf[digits - i] = '\0';
+
+   return digits - i;
+}
+
+size_t nn_get_str_buf(char * buf, size_t cap, nn_src_t a, len_t m)
+{
+   return _nn_get_str_buf(buf, cap, a, m, 1);
+}
+
+char * nn_get_str(nn_src_t a, len_t m)
+{
+   size_t cap = nn_sizeinbase(a, m, 10) + 1;
+   char * str = (char *) malloc(cap);
+
+   _nn_get_str_buf(str, cap, a, m, 1);
+
+   return str;
+}
+
+char * nn_get_str_threaded(nn_src_t a, len_t m, long threads)
+{
+   size_t cap = nn_sizeinbase(a, m, 10) + 1;
+   char * str = (char *) malloc(cap);
+
+   _nn_get_str_buf(str, cap, a, m, threads);
+
+   return str;
+}
+
+size_t nn_out_str(FILE * f, nn_src_t a, len_t m)
+{
+   char buf[NN_OUT_STR_BUF];
+   size_t n;
+   nn_t t;
+   TMP_INIT;
+
+   while (m > 0 && a[m - 1] == 0)
+      m--;
+
+   /* small values are converted into a buffer on the stack */
+   if ((n = nn_get_str_buf(buf, NN_OUT_STR_BUF, a, m)) != 0)
+      return fwrite(buf, 1, n, f);
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(m);
+   nn_copy(t, a, m);
+
+   n = nn_out_str_divconquer(f, t, m);
+
+   TMP_END;
+
+   return n;
+}
+
+len_t nn_set_strn(nn_t a, const char * str, size_t digits)
+{
+   if (digits < (size_t) SET_STR_DIVCONQUER_CUTOFF*DEC_WORD_DIGITS)
+      return nn_set_str_classical(a, str, digits);
+   else
+      return nn_set_str_divconquer(a, str, digits);
+}
+
+size_t nn_set_str(nn_t a, len_t * len, const char * str)
+{
+   size_t digits = strspn(str, "0123456789");
+
+   *len = nn_set_strn(a, str, digits);
+
+   return digits;
+}
+
+char * nn_get_str_base(nn_src_t a, len_t m, int base)
+{
+   size_t i, digits;
+   bits_t k;
+   char * str;
+   nn_t t;
+   TMP_INIT;
+
+   ASSERT(base >= 2 && base <= 62);
+
+   if (base == 10)
+      return nn_get_str(a, m);
+
+   while (m > 0 && a[m - 1] == 0)
+      m--;
+
+   if (m == 0)
+   {
+      str = (char *) malloc(2);
+      strcpy(str, "0");
+      return str;
+   }
+
+   if ((base & (base - 1)) == 0) /* power of 2 */
+   {
+      k = low_zero_bits(base);
+      str = (char *) malloc(nn_sizeinbase(a, m, base) + 1);
+      digits = nn_get_str_pow2(str, a, m, k);
+      str[digits] = '\0';
+
+      return str;
+   }
+
+   digits = nn_sizeinbase(a, m, base);
+   str = (char *) malloc(digits + 1);
+   
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(m);
+   nn_copy(t, a, m);
+
+   nn_get_str_base_classical(str, digits, t, m, base);
+
+   TMP_END;
+
+   /* remove leading zeroes */
+   for (i = 0; i < digits - 1 && str[i] == '0'; i++) ;
+   
+   if (i)
+      memmove(str, str + i, digits - i);
+
+   str[digits - i] = '\0';
+
+   return str;
+}
+
+size_t nn_set_str_base(nn_t a, len_t * len, const char * str, int base)
+{
+   size_t digits = 0;
+
+   ASSERT(base >= 2 && base <= 62);
+
+   if (base == 10)
+      return nn_set_str(a, len, str);
+
+   while (nn_digit_value(str[digits], base) < base)
+      digits++;
+
+   if ((base & (base - 1)) == 0) /* power of 2 */
+      *len = nn_set_str_pow2(a, str, digits, low_zero_bits(base));
+   else
+      *len = nn_set_str_base_classical(a, str, digits, base);
+
+   return digits;
+}
+
 void nn_mul_m(nn_t p, nn_src_t a, nn_src_t b, len_t m)
 {
-   if (m <= MUL_CLASSICAL_CUTOFF)
+   if (m <= MUL_FIXED_CUTOFF)
+      nn_mul_fixed(p, a, b, m);
+   else if (m <= MUL_CLASSICAL_CUTOFF)
       nn_mul_classical(p, a, m, b, m);
    else if (m <= MUL_KARA_CUTOFF)
       nn_mul_kara(p, a, m, b, m);
@@ -40,12 +253,28 @@ void nn_mul_m(nn_t p, nn_src_t a, nn_src_t b, len_t m)
       talker("Out of options in nn_mul_m\n");
 }
 
+void nn_sqr(nn_t p, nn_src_t a, len_t m)
+{
+   if (m <= MUL_FIXED_CUTOFF)
+      nn_sqr_fixed(p, a, m);
+   else if (m <= SQR_CLASSICAL_CUTOFF)
+      nn_sqr_classical(p, a, m);
+   else
+      nn_mul(p, a, m, a, m);
+}
+
 void nn_mul(nn_t p, nn_src_t a, len_t m, nn_src_t b, len_t n)
 {
    len_t r;
    nn_t t;
    TMP_INIT;
    
+   if (m == n && n <= MUL_FIXED_CUTOFF)
+   {
+      nn_mul_fixed(p, a, b, n);
+      return;
+   }
+
    if (n <= MUL_CLASSICAL_CUTOFF)
    {
       nn_mul_classical(p, a, m, b, n);
@@ -210,3 +439,929 @@ void nn_div(nn_t q, nn_t a, len_t m, nn_src_t d, len_t n)
 
    TMP_END;
 }
+
+void nn_invert_hensel(nn_t r, nn_src_t a, len_t m)
+{
+   len_t h = (m + 1)/2;
+   nn_t t;
+   TMP_INIT;
+
+   ASSERT(m > 0);
+   ASSERT(a[0] & 1);
+   ASSERT(r != a);
+
+   if (m == 1)
+   {
+      precompute_hensel_inverse1(r, a[0]);
+      return;
+   }
+
+   nn_invert_hensel(r, a, h);
+
+   TMP_START;
+   t = (nn_t) TMP_ALLOC(m + 2);
+
+   /* a*x = 1 + B^h*e mod B^m, where x = {r, h} */
+   nn_mullow(t + m, t, a, m, r, h);
+   
+   /* x*(2 - a*x) = x - B^h*x*e mod B^m */
+   nn_mullow(t + m, r + h, r, m - h, t + h, m - h);
+   nn_neg(r + h, r + h, m - h);
+
+   TMP_END;
+}
+
+int nn_invmod(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t n)
+{
+   len_t i, s;
+   nn_t t, u, g, v;
+   TMP_INIT;
+
+   ASSERT(n > 0);
+   ASSERT(n >= m);
+   ASSERT(d[n - 1] != 0);
+   ASSERT(r != d);
+
+   while (m > 0 && a[m - 1] == 0)
+      m--;
+
+   if (n == 1 && d[0] == 1)
+   {
+      r[0] = 0;
+      return 1;
+   }
+
+   if (m == 0)
+      return 0;
+
+   if (n == 1 && (d[0] & 1)) /* odd single word modulus */
+   {
+      word_t inv = invmod1_binary(a[0], d[0]);
+      
+      if (inv == 0)
+         return 0;
+
+      r[0] = inv;
+      return 1;
+   }
+   
+   for (i = 0; i < n - 1 && d[i] == 0; i++) ;
+
+   if (i == n - 1 && (d[n - 1] & (d[n - 1] - 1)) == 0) /* power of 2 */
+   {
+      bits_t bits = low_zero_bits(d[n - 1]);
+      
+      if ((a[0] & 1) == 0)
+         return 0;
+      
+      s = bits == 0 ? n - 1 : n; /* words in d - 1 */
+
+      TMP_START;
+      t = (nn_t) TMP_ALLOC(s);
+      nn_copy(t, a, m);
+      nn_zero(t + m, s - m);
+
+      nn_invert_hensel(r, t, s);
+
+      if (bits != 0)
+         r[s - 1] &= ((WORD(1) << bits) - 1);
+      nn_zero(r + s, n - s);
+
+      TMP_END;
+      return 1;
+   }
+  
+   TMP_START;
+   t = (nn_t) TMP_ALLOC(n);
+   u = (nn_t) TMP_ALLOC(n);
+   g = (nn_t) TMP_ALLOC(n);
+   v = (nn_t) TMP_ALLOC(n);
+
+   nn_copy(t, d, n);
+   nn_copy(u, a, m);
+   
+   /* g = (-a)*v mod d */
+   s = nn_xgcd(g, v, t, n, u, m);
+
+   if (s != 1 || g[0] != 1)
+   {
+      TMP_END;
+      return 0;
+   }
+
+   nn_sub_m(r, d, v, n);
+
+   TMP_END;
+   return 1;
+}
+
+void nn_multi_mod(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t num)
+{
+   nn_t * tree, rem, next, t, q;
+   len_t * count;
+   len_t i, j, k, s, levels, leaf, max, n1, n2, rn;
+   mod_preinv1_t inv;
+   TMP_INIT;
+
+   ASSERT(num > 0);
+   ASSERT(m >= 0);
+
+   if (num <= MULTI_MOD_CUTOFF) /* reduce by each modulus directly */
+   {
+      for (i = 0; i < num; i++)
+      {
+         precompute_mod_inverse1(&inv, d[i]);
+         r[i] = nn_mod1_preinv(a, m, d[i], inv);
+      }
+
+      return;
+   }
+
+   TMP_START;
+
+   /* 
+      Level k of the tree has count[k] entries, each the product of 
+      (up to) 2^k moduli, stored with a stride of 2^k words. Level 0
+      is d itself and the top level has a single entry.
+   */
+   for (levels = 1, k = num; k > 1; levels++)
+      k = (k + 1)/2;
+
+   tree = (nn_t *) TMP_ALLOC_BYTES(levels*sizeof(nn_t));
+   count = (len_t *) TMP_ALLOC_BYTES(levels*sizeof(len_t));
+
+   tree[0] = (nn_t) d;
+   count[0] = num;
+   max = num;
+
+   for (k = 1, s = 2; k < levels; k++, s *= 2)
+   {
+      count[k] = (count[k - 1] + 1)/2;
+      tree[k] = (nn_t) TMP_ALLOC(count[k]*s);
+      max = BSDNT_MAX(max, count[k]*s);
+
+      for (j = 0; j < count[k]; j++)
+      {
+         n1 = nn_normalise(tree[k - 1] + 2*j*(s/2), s/2);
+
+         if (2*j + 1 < count[k - 1]) 
+         {
+            n2 = nn_normalise(tree[k - 1] + (2*j + 1)*(s/2), s/2);
+            
+            if (n1 >= n2)
+               nn_mul(tree[k] + j*s, tree[k - 1] + 2*j*(s/2), n1, 
+                                     tree[k - 1] + (2*j + 1)*(s/2), n2);
+            else
+               nn_mul(tree[k] + j*s, tree[k - 1] + (2*j + 1)*(s/2), n2, 
+                                     tree[k - 1] + 2*j*(s/2), n1);
+            
+            nn_zero(tree[k] + j*s + n1 + n2, s - n1 - n2);
+         } else /* unpaired entry */
+         {
+            nn_copy(tree[k] + j*s, tree[k - 1] + 2*j*(s/2), n1);
+            nn_zero(tree[k] + j*s + n1, s - n1);
+         }
+      }
+   }
+
+   k = levels - 1;
+   s = (len_t) 1 << k;
+
+   rem = (nn_t) TMP_ALLOC(max);
+   next = (nn_t) TMP_ALLOC(max);
+   t = (nn_t) TMP_ALLOC(BSDNT_MAX(m, 2*s));
+   q = (nn_t) TMP_ALLOC(BSDNT_MAX(m, 2*s) + 1);
+   
+   /* reduce a by the root of the tree */
+   n1 = nn_normalise(tree[k], s);
+      
+   nn_copy(t, a, m);
+   rn = nn_normalise(t, m);
+
+   if (rn >= n1)
+   {
+      nn_divrem(q, t, rn, tree[k], n1);
+      rn = n1;
+   }
+      
+   nn_copy(rem, t, rn);
+   nn_zero(rem + rn, s - rn);
+   
+   /* reduce each remainder by its two children, down to the cutoff */
+   for (k--; k >= 0 && s > MULTI_MOD_CUTOFF; k--)
+   {
+      s /= 2;
+
+      for (j = 0; j < count[k]; j++)
+      {
+         n1 = nn_normalise(tree[k] + j*s, s);
+         
+         nn_copy(t, rem + (j/2)*(2*s), 2*s);
+         rn = nn_normalise(t, 2*s);
+
+         if (rn >= n1)
+         {
+            nn_divrem(q, t, rn, tree[k] + j*s, n1);
+            rn = n1;
+         }
+      
+         nn_copy(next + j*s, t, rn);
+         nn_zero(next + j*s + rn, s - rn);
+      }
+
+      TYPED_SWAP(nn_t, rem, next);
+   }
+
+   /* reduce each remainder by the s moduli below it */
+   for (i = 0, leaf = 0; i < num; leaf++)
+   {
+      rn = nn_normalise(rem + leaf*s, s);
+
+      for (j = 0; j < s && i < num; j++, i++)
+      {
+         precompute_mod_inverse1(&inv, d[i]);
+         r[i] = nn_mod1_preinv(rem + leaf*s, rn, d[i], inv);
+      }
+   }
+
+   TMP_END;
+}
+
+void nn_mod_2exp_minus_c(nn_t r, nn_src_t a, len_t m, bits_t k, word_t c)
+{
+   const len_t n = (k + WORD_BITS - 1)/WORD_BITS, s = k/WORD_BITS;
+   const bits_t b = k % WORD_BITS;
+   const word_t mask = (WORD(1) << b) - 1;
+   len_t len = BSDNT_MAX(m, n), hl, l2;
+   word_t ci;
+   nn_t t, h;
+   TMP_INIT;
+
+   ASSERT(k > 1);
+   ASSERT(k > WORD_BITS || c < (WORD(1) << (k - 1)));
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(len + 1);
+   h = (nn_t) TMP_ALLOC(len + 1);
+
+   nn_copy(t, a, m);
+   nn_zero(t + m, len + 1 - m);
+
+   /* fold t = H*2^k + L to L + c*H until t < 2^k */
+   while (1)
+   {
+      len = nn_normalise(t, len);
+
+      if (len < n || (len == n && (b == 0 || (t[n - 1] >> b) == 0)))
+         break;
+
+      hl = len - s;
+      nn_shr(h, t + s, hl, b);
+      if (b != 0)
+         t[s] &= mask;
+
+      l2 = BSDNT_MAX(n, hl);
+      nn_zero(t + n, l2 - n + 1);
+
+      ci = nn_addmul1(t, h, hl, c);
+      if (hl < l2)
+         ci = nn_add1(t + hl, t + hl, l2 - hl, ci);
+      t[l2] = ci;
+
+      len = l2 + 1;
+   }
+
+   /* subtract 2^k - c if t >= 2^k - c, i.e. t + c >= 2^k */
+   ci = nn_add1(r, t, n, c);
+   if (b != 0 ? (r[n - 1] >> b) != 0 : ci != 0)
+   {
+      if (b != 0)
+         r[n - 1] &= mask;
+   } else
+      nn_copy(r, t, n);
+
+   TMP_END;
+}
+
+void nn_sqrsub_mod_2exp_minus_c(nn_t r, nn_src_t a, bits_t k, word_t c, 
+                                                   word_t d, len_t iter)
+{
+   const len_t n = (k + WORD_BITS - 1)/WORD_BITS;
+   const bits_t b = k % WORD_BITS;
+   len_t i;
+   nn_t t, p;
+   TMP_INIT;
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(2*n);
+   p = (nn_t) TMP_ALLOC(n);
+
+   /* p = 2^k - c */
+   nn_zero(p, n);
+   if (b != 0)
+      p[n - 1] = (WORD(1) << b);
+   nn_sub1(p, p, n, c);
+
+   nn_copy(r, a, n);
+
+   for (i = 0; i < iter; i++)
+   {
+      nn_sqr(t, r, n);
+
+      /* if r^2 < d then r^2 - d + p = p + t - B^(2n) */
+      if (nn_sub1(t, t, 2*n, d))
+         nn_add_m(r, p, t, n);
+      else
+         nn_mod_2exp_minus_c(r, t, 2*n, k, c);
+   }
+
+   TMP_END;
+}
+
+void nn_normmod_2expp1(nn_t r, len_t n)
+{
+   sword_t hi = (sword_t) r[n];
+
+   r[n] = 0;
+
+   /* lo + hi*B^n = lo - hi */
+   if (hi >= 0)
+   {
+      if (nn_sub1(r, r, n, hi)) /* -B^n = 1 */
+         r[n] = nn_add1(r, r, n, 1);
+   } else
+   {
+      if (nn_add1(r, r, n, -hi)) /* B^n = -1 */
+      {
+         if (nn_sub1(r, r, n, 1)) /* wrapped to -1 = B^n */
+         {
+            nn_zero(r, n);
+            r[n] = 1;
+         }
+      }
+   }
+}
+
+void nn_mulmod_2expp1(nn_t r, nn_src_t a, nn_src_t b, len_t n)
+{
+   const len_t h = n/2;
+   word_t ci;
+   nn_t t, x, y, z, sa, sb;
+   TMP_INIT;
+
+   ASSERT(n > 0);
+   
+   if (a[n] != 0 || b[n] != 0) /* one of a or b is -1 */
+   {
+      if (a[n] != 0 && b[n] != 0)
+      {
+         nn_zero(r, n + 1);
+         r[0] = 1;
+      } else
+      {
+         nn_neg(r, a[n] != 0 ? b : a, n);
+         r[n] = 0;
+         if (nn_normalise(r, n) != 0)
+            r[n] = nn_add1(r, r, n, 1);
+      }
+
+      return;
+   }
+
+   TMP_START;
+
+   if ((n & 1) != 0 || n < MULMOD_2EXPP1_KARA_CUTOFF)
+   {
+      t = (nn_t) TMP_ALLOC(2*n);
+
+      /* lo + hi*B^n = lo - hi */
+      nn_mul_m(t, a, b, n);
+      r[n] = 0;
+      if (nn_sub_m(r, t, t + n, n)) /* -B^n = 1 */
+         r[n] = nn_add1(r, r, n, 1);
+   } else
+   {
+      x = (nn_t) TMP_ALLOC(n);
+      y = (nn_t) TMP_ALLOC(n);
+      z = (nn_t) TMP_ALLOC(n + 2);
+      sa = (nn_t) TMP_ALLOC(h + 1);
+      sb = (nn_t) TMP_ALLOC(h + 1);
+
+      /* x = a0*b0, y = a1*b1, z = (a0 + a1)*(b0 + b1) - x - y */
+      nn_mul_m(x, a, b, h);
+      nn_mul_m(y, a + h, b + h, h);
+      
+      sa[h] = nn_add_m(sa, a, a + h, h);
+      sb[h] = nn_add_m(sb, b, b + h, h);
+      nn_mul_m(z, sa, sb, h + 1);
+      nn_sub(z, z, n + 2, x, n);
+      nn_sub(z, z, n + 2, y, n);
+
+      /* 
+         with X = B^h and X^2 = -1 the product is x - y + z*X, and 
+         z*X = zlo*X - zhi, where zlo is the low h words of z
+      */
+      nn_copy(r, x, n);
+      r[n] = -nn_sub_m(r, r, y, n);
+      
+      ci = nn_add_m(r + h, r + h, z, h);
+      r[n] += ci;
+
+      ci = nn_sub(r, r, n, z + h, h + 1);
+      r[n] -= ci;
+
+      nn_normmod_2expp1(r, n);
+   }
+
+   TMP_END;
+}
+
+/*
+   Return s = floor(sqrt(a)) and set r = a - s^2, where a = a1*B + a0,
+   a1 >= B/4 and r = {r, 2}. The double precision estimate is good to 
+   about 50 bits, so one Newton step leaves s off by at most one or two.
+*/
+static inline
+word_t _n_sqrtrem2(nn_t r, word_t a1, word_t a0)
+{
+   const dword_t a = ((dword_t) a1 << WORD_BITS) + a0;
+   double f = sqrt((double) a1)*ldexp(1.0, WORD_BITS/2);
+   dword_t s, t;
+
+   s = f >= ldexp(1.0, WORD_BITS) ? ~WORD(0) : (word_t) f;
+   s = (s + a/s)/2;
+   if (s > ~WORD(0))
+      s = ~WORD(0);
+
+   while (s*s > a)
+      s--;
+
+   while (s < ~WORD(0) && (s + 1)*(s + 1) <= a)
+      s++;
+
+   t = a - s*s;
+   r[0] = (word_t) t;
+   r[1] = (word_t) (t >> WORD_BITS);
+
+   return (word_t) s;
+}
+
+/*
+   Set {s, n} = floor(sqrt(a)) and {r, n + 1} = a - s^2 where {a, 2n} 
+   has a[2n - 1] >= B/4.
+*/
+static
+void _nn_sqrtrem_norm(nn_t s, nn_t r, nn_src_t a, len_t n)
+{
+   const len_t l = n/2, h = n - l;
+   nn_t num, den, q, t;
+   TMP_INIT;
+
+   if (n == 1)
+   {
+      s[0] = _n_sqrtrem2(r, a[1], a[0]);
+      return;
+   }
+
+   TMP_START;
+
+   num = (nn_t) TMP_ALLOC(h + l + 1);
+   den = (nn_t) TMP_ALLOC(h + 1);
+   q = (nn_t) TMP_ALLOC(l + 1);
+   t = (nn_t) TMP_ALLOC(2*l + 2);
+
+   /* s', r' = sqrtrem of the top 2h words, with r' = {num + l, h + 1} */
+   _nn_sqrtrem_norm(s + l, num + l, a + 2*l, h);
+
+   /* q, u = (r'*B^l + a1) divrem 2s', with u = {num, h + 1} */
+   nn_copy(num, a + l, l);
+   den[h] = nn_shl(den, s + l, h, 1);
+   nn_divrem(q, num, h + l + 1, den, h + 1);
+
+   /* s = s'*B^l + q, where q <= B^l */
+   nn_copy(s, q, l);
+   nn_add1(s + l, s + l, h, q[l]);
+
+   /* r = u*B^l + a0 - q^2 */
+   nn_copy(r, a, l);
+   nn_copy(r + l, num, h + 1);
+   nn_sqr(t, q, l + 1);
+
+   /* if r < 0, set r = r + 2s - 1 and s = s - 1 */
+   if (nn_sub(r, r, n + 1, t, BSDNT_MIN(2*l + 2, n + 1)) 
+          || (2*l + 2 > n + 1 && t[n + 1] != 0))
+   {
+      nn_sub1(s, s, n, 1);
+      r[n] += nn_add_m(r, r, s, n);
+      r[n] += nn_add_m(r, r, s, n);
+      nn_add1(r, r, n + 1, 1);
+   }
+
+   TMP_END;
+}
+
+len_t nn_sqrtrem(nn_t s, nn_t r, nn_src_t a, len_t m)
+{
+   const len_t n = (m + 1)/2;
+   const int odd = (m & 1);
+   const bits_t c = high_zero_bits(a[m - 1])/2;
+   const bits_t t = c + odd*(WORD_BITS/2);
+   nn_t b, u;
+   TMP_INIT;
+
+   ASSERT(m > 0);
+   ASSERT(a[m - 1] != 0);
+
+   TMP_START;
+   
+   b = (nn_t) TMP_ALLOC(2*n);
+   u = (nn_t) TMP_ALLOC(2*n + 1);
+
+   /* shift a left by 2t bits, so that b[2n - 1] >= B/4 */
+   b[0] = 0;
+   nn_shl(b + odd, a, m, 2*c);
+   
+   if (t == 0)
+      _nn_sqrtrem_norm(s, r, b, n);
+   else
+   {
+      /* sqrt(a) = sqrt(b)/2^t, and r is recomputed */
+      _nn_sqrtrem_norm(u, r, b, n);
+      nn_shr(s, u, n, t);
+      
+      nn_sqr(u, s, n);
+      nn_sub_m(b, a, u, m);
+      nn_copy(r, b, BSDNT_MIN(m, n + 1));
+      if (m < n + 1)
+         r[m] = 0;
+   }
+
+   TMP_END;
+
+   return nn_normalise(r, n + 1);
+}
+
+void nn_mont_set(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t n)
+{
+   const len_t k = BSDNT_MAX(m + n, n);
+   nn_t t, q;
+   TMP_INIT;
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(k);
+   q = (nn_t) TMP_ALLOC(k - n + 1);
+
+   nn_zero(t, k);
+   nn_copy(t + n, a, m);
+   nn_divrem(q, t, k, d, n);
+   nn_copy(r, t, n);
+
+   TMP_END;
+}
+
+void nn_mont_mul_tmp(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n, 
+                                         hensel_preinv1_t dinv, nn_t t)
+{
+   if (n <= MUL_FIXED_CUTOFF)
+   {
+      nn_mont_mul_fixed(r, a, b, d, n, dinv);
+      return;
+   }
+
+   if (a == b)
+      nn_sqr(t, a, n);
+   else
+      nn_mul_m(t, a, b, n);
+
+   nn_redc_classical(r, t, d, n, dinv);
+}
+
+void nn_mont_mul(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n, 
+                                                   hensel_preinv1_t dinv)
+{
+   TMP_INIT;
+
+   if (n <= MUL_FIXED_CUTOFF)
+   {
+      nn_mont_mul_fixed(r, a, b, d, n, dinv);
+      return;
+   }
+
+   TMP_START;
+
+   nn_mont_mul_tmp(r, a, b, d, n, dinv, (nn_t) TMP_ALLOC(2*n));
+
+   TMP_END;
+}
+
+void nn_mont_get(nn_t r, nn_src_t a, nn_src_t d, len_t n, 
+                                                   hensel_preinv1_t dinv)
+{
+   nn_t t;
+   TMP_INIT;
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(2*n);
+
+   nn_copy(t, a, n);
+   nn_zero(t + n, n);
+   nn_redc_classical(r, t, d, n, dinv);
+
+   TMP_END;
+}
+
+/*
+   Modulus and scratch space for nn_powm. For odd moduli arithmetic is
+   in Montgomery form and dinv is the Hensel inverse of d[0].
+*/
+typedef struct _nn_powm_ctx_t
+{
+   nn_src_t d;
+   len_t n;
+   int redc;
+   hensel_preinv1_t dinv;
+   nn_t t; /* 2*n words */
+   nn_t q; /* n + 1 words */
+} _nn_powm_ctx_t;
+
+/*
+   Set {r, n} = {a, n}*{b, n} mod d, in Montgomery form if ctx->redc is
+   set. The output r may alias a or b.
+*/
+static inline
+void _nn_powm_mulmod(nn_t r, nn_src_t a, nn_src_t b, _nn_powm_ctx_t * ctx)
+{
+   const len_t n = ctx->n;
+
+   if (a == b)
+      nn_sqr(ctx->t, a, n);
+   else
+      nn_mul_m(ctx->t, a, b, n);
+
+   if (ctx->redc && n <= MUL_FIXED_CUTOFF)
+      nn_redc_fixed(r, ctx->t, ctx->d, n, ctx->dinv);
+   else if (ctx->redc)
+      nn_redc_classical(r, ctx->t, ctx->d, n, ctx->dinv);
+   else
+   {
+      nn_divrem(ctx->q, ctx->t, 2*n, ctx->d, n);
+      nn_copy(r, ctx->t, n);
+   }
+}
+
+/*
+   Return the window size for sliding window powering with an exponent
+   of the given number of bits.
+*/
+static inline
+int _nn_powm_window(bits_t bits)
+{
+   static const bits_t max_bits[] = { 8, 24, 80, 240, 672, 1792 };
+   int w;
+
+   for (w = 0; w < 6 && bits > max_bits[w]; w++) ;
+
+   return w + 1;
+}
+
+void nn_powm(nn_t r, nn_src_t a, len_t m, nn_src_t e, len_t en, 
+                                                    nn_src_t d, len_t n)
+{
+   _nn_powm_ctx_t ctx;
+   nn_t tab, t;
+   bits_t i, j, bits;
+   word_t val;
+   len_t k;
+   int w;
+   TMP_INIT;
+
+   ASSERT(n > 0 && d[n - 1] != 0);
+   ASSERT(r != d && r != e && r != a);
+
+   while (en > 0 && e[en - 1] == 0)
+      en--;
+
+   if (en == 0) /* a^0 = 1 */
+   {
+      nn_zero(r, n);
+      r[0] = (n > 1 || d[0] != 1);
+      return;
+   }
+
+   bits = en*WORD_BITS - high_zero_bits(e[en - 1]);
+   w = _nn_powm_window(bits);
+
+   TMP_START;
+
+   ctx.d = d;
+   ctx.n = n;
+   ctx.redc = (d[0] & 1);
+   ctx.t = (nn_t) TMP_ALLOC(2*n);
+   ctx.q = (nn_t) TMP_ALLOC(BSDNT_MAX(m, n) + 1);
+
+   if (ctx.redc)
+      precompute_hensel_inverse1(&ctx.dinv, d[0]);
+   else
+      ctx.dinv = 0;
+
+   /* tab[k] = a^(2k + 1) mod d, for k < 2^(w - 1) */
+   tab = (nn_t) TMP_ALLOC(n << (w - 1));
+   
+   /* tab[0] = a mod d, or a*B^n mod d in Montgomery form */
+   k = ctx.redc ? n : 0;
+   t = (nn_t) TMP_ALLOC(m + k + n);
+   nn_zero(t, m + k + n);
+   nn_copy(t + k, a, m);
+   nn_divrem(ctx.q, t, BSDNT_MAX(m + k, n), d, n);
+   nn_copy(tab, t, n);
+
+   if (w > 1)
+   {
+      _nn_powm_mulmod(r, tab, tab, &ctx); /* r = a^2 */
+
+      for (k = 1; k < (WORD(1) << (w - 1)); k++)
+         _nn_powm_mulmod(tab + k*n, tab + (k - 1)*n, r, &ctx);
+   }
+
+   /* scan the exponent from the top, starting with the leading window */
+   for (i = bits - 1, j = 0; i >= 0; )
+   {
+      if (!nn_bit_test(e, i))
+      {
+         _nn_powm_mulmod(r, r, r, &ctx);
+         i--;
+         continue;
+      }
+
+      /* the longest window of at most w bits ending in a 1 */
+      j = BSDNT_MAX(i - w + 1, 0);
+      while (!nn_bit_test(e, j))
+         j++;
+
+      for (val = 0, k = i; k >= j; k--)
+         val = 2*val + nn_bit_test(e, k);
+
+      if (i == bits - 1)
+         nn_copy(r, tab + (val >> 1)*n, n);
+      else
+      {
+         for (k = i; k >= j; k--)
+            _nn_powm_mulmod(r, r, r, &ctx);
+
+         _nn_powm_mulmod(r, r, tab + (val >> 1)*n, &ctx);
+      }
+
+      i = j - 1;
+   }
+
+   /* convert out of Montgomery form */
+   if (ctx.redc)
+   {
+      nn_copy(ctx.t, r, n);
+      nn_zero(ctx.t + n, n);
+      nn_redc_classical(r, ctx.t, d, n, ctx.dinv);
+   }
+
+   TMP_END;
+}
+
+/*
+   Set {r, n} = {a, n}*{b, n}*B^(-n) mod d using only the side channel
+   resistant primitives. The scratch space t must have 2*n words. The
+   output r may alias a or b.
+*/
+static inline
+void _nn_mulredc_sec(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n,
+                                          hensel_preinv1_t dinv, nn_t t)
+{
+   if (a == b)
+      nn_sqr_classical(t, a, n);
+   else
+      nn_mul_classical(t, a, n, b, n);
+
+   nn_redc_sec_classical(r, t, d, n, dinv);
+}
+
+/*
+   Set {r, n} to entry k of the table of size entries of n words, 
+   reading every entry.
+*/
+static inline
+void _nn_powm_sec_lookup(nn_t r, nn_src_t tab, len_t n, 
+                                                 word_t size, word_t k)
+{
+   word_t i, mask;
+   len_t j;
+
+   nn_zero(r, n);
+
+   for (i = 0; i < size; i++, tab += n)
+   {
+      mask = ~nn_cnd_mask(i ^ k);
+
+      for (j = 0; j < n; j++)
+         r[j] |= (tab[j] & mask);
+   }
+}
+
+/*
+   Return the w bits of e ending just below bit i, i.e. bits i - w to 
+   i - 1, where i >= w.
+*/
+static inline
+word_t _nn_powm_sec_bits(nn_src_t e, bits_t i, int w)
+{
+   const len_t k = (i - w)/WORD_BITS;
+   const bits_t s = (i - w) % WORD_BITS;
+   word_t v = e[k] >> s;
+
+   if (s + w > WORD_BITS)
+      v |= e[k + 1] << (WORD_BITS - s);
+
+   return v & ((WORD(1) << w) - 1);
+}
+
+void nn_powm_sec(nn_t r, nn_src_t a, len_t m, nn_src_t e, len_t en, 
+                                                    nn_src_t d, len_t n)
+{
+   hensel_preinv1_t dinv;
+   nn_t tab, t, u, q, s;
+   word_t size, k;
+   bits_t i;
+   int w;
+   TMP_INIT;
+
+   ASSERT(n > 0 && (d[0] & 1) && d[n - 1] != 0);
+   ASSERT(r != d && r != e && r != a);
+
+   TMP_START;
+
+   precompute_hensel_inverse1(&dinv, d[0]);
+
+   w = _nn_powm_window(en*WORD_BITS);
+   size = WORD(1) << w;
+
+   tab = (nn_t) TMP_ALLOC(size*n);
+   t = (nn_t) TMP_ALLOC(2*n + 1);
+   u = (nn_t) TMP_ALLOC(n);
+   q = (nn_t) TMP_ALLOC(BSDNT_MAX(m, n) + 2);
+
+   /* tab[0] = B^n mod d, u = B^2n mod d, both depending only on d */
+   nn_zero(t, 2*n);
+   t[2*n] = 1;
+   nn_divrem(q, t, 2*n + 1, d, n);
+   nn_copy(u, t, n);
+   
+   nn_zero(t, n);
+   t[n] = 1;
+   nn_divrem(q, t, n + 1, d, n);
+   nn_copy(tab, t, n);
+
+   /* tab[1] = a*B^n mod d */
+   nn_zero(r, n);
+   if (m > n)
+   {
+      s = (nn_t) TMP_ALLOC(m);
+      nn_copy(s, a, m);
+      nn_divrem(q, s, m, d, n);
+      nn_copy(r, s, n);
+   } else
+      nn_copy(r, a, m);
+
+   _nn_mulredc_sec(tab + n, r, u, d, n, dinv, t);
+
+   /* tab[k] = a^k*B^n mod d */
+   for (k = 2; k < size; k++)
+      _nn_mulredc_sec(tab + k*n, tab + (k - 1)*n, tab + n, d, n, dinv, t);
+
+   /* the leading window takes the remaining (en*WORD_BITS) % w bits */
+   i = en*WORD_BITS;
+   if (i % w != 0)
+   {
+      _nn_powm_sec_lookup(r, tab, n, size, 
+                                       _nn_powm_sec_bits(e, i, i % w));
+      i -= i % w;
+   } else
+      nn_copy(r, tab, n);
+
+   for ( ; i > 0; i -= w)
+   {
+      for (k = 0; k < (word_t) w; k++)
+         _nn_mulredc_sec(r, r, r, d, n, dinv, t);
+
+      _nn_powm_sec_lookup(u, tab, n, size, _nn_powm_sec_bits(e, i, w));
+      _nn_mulredc_sec(r, r, u, d, n, dinv, t);
+   }
+
+   /* convert out of Montgomery form */
+   nn_copy(t, r, n);
+   nn_zero(t + n, n);
+   nn_redc_sec_classical(r, t, d, n, dinv);
+
+   TMP_END;
+}
+
@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <stdio.h>
 #if defined(__MINGW32__)
 	#include <malloc.h>
 #endif
@@ -132,19 +133,130 @@ void nn_printx_short(nn_src_t a, len_t m);
 */
 void nn_printx_diff(nn_src_t a, nn_src_t b, len_t m);
 
+/*
+   The largest power of 10 which fits in a word, and its exponent.
+*/
+#if WORD_BITS == 64
+#define DEC_WORD_DIGITS 19
+#define DEC_WORD_BASE WORD(10000000000000000000)
+#else
+#define DEC_WORD_DIGITS 9
+#define DEC_WORD_BASE WORD(1000000000)
+#endif
+
+/*
+   Return the number of digits of {a, m} in the given base, where 
+   2 <= base <= 62, or one more than that. The result is exact when 
+   the base is a power of 2. If m is zero, 1 is returned.
+*/
+size_t nn_sizeinbase(nn_src_t a, len_t m, int base);
+
+/*
+   Write the decimal representation of {a, m}, with a terminating null
+   character, to the buffer buf of cap characters. The number of 
+   digits written is returned. If cap <= nn_sizeinbase(a, m, 10) then
+   nothing is written and 0 is returned. Above 
+   GET_STR_DIVCONQUER_CUTOFF words, nn_get_str_divconquer is used.
+*/
+size_t nn_get_str_buf(char * buf, size_t cap, nn_src_t a, len_t m);
+
 /*
    Return a string representation of {a, m} in decimal. The user is
    responsible for freeing the string.
 */
 char * nn_get_str(nn_src_t a, len_t m);
 
+/*
+   As per nn_get_str, but using up to the given number of threads for 
+   values above GET_STR_DIVCONQUER_CUTOFF words. See 
+   nn_get_str_divconquer_threaded. Unless bsdnt was configured with
+   --enable-threads, the conversion is done in the calling thread.
+*/
+char * nn_get_str_threaded(nn_src_t a, len_t m, long threads);
+
+/*
+   The size of the stack buffer used by nn_out_str for small values.
+*/
+#define NN_OUT_STR_BUF 512
+
+/*
+   Write the decimal representation of {a, m} to the stream f and 
+   return the number of characters written. Values of fewer than 
+   NN_OUT_STR_BUF digits are formatted in a buffer on the stack, 
+   larger ones are written a block of digits at a time by 
+   nn_out_str_divconquer.
+*/
+size_t nn_out_str(FILE * f, nn_src_t a, len_t m);
+
 /*
    Set {a, *len} to the natural number given by the string str. If
    the string is "0" then len is set to 0. The function returns the
-   number of digits read, where "0" counts as a single digit.
+   number of digits read, where "0" counts as a single digit. Above
+   SET_STR_DIVCONQUER_CUTOFF words, nn_set_str_divconquer is used.
 */
 size_t nn_set_str(nn_t a, len_t * len, const char * str);
 
+/*
+   Set a to the natural number given by the first digits characters of
+   str, which must all be decimal digits, and return its length. The 
+   output a must have space for digits*log_2(10)/WORD_BITS + 1 words.
+*/
+len_t nn_set_strn(nn_t a, const char * str, size_t digits);
+
+/*
+   Return the character for the digit d in the given base, 2 <= base 
+   <= 62. For bases up to 36 the digits are 0-9 then a-z, for larger
+   bases they are 0-9, A-Z then a-z.
+*/
+static inline
+char nn_digit_char(word_t d, int base)
+{
+   if (d < 10)
+      return '0' + (char) d;
+   else if (base <= 36 || d < 36)
+      return (base <= 36 ? 'a' : 'A') + (char) (d - 10);
+   else
+      return 'a' + (char) (d - 36);
+}
+
+/*
+   Return the value of the digit c in the given base, 2 <= base <= 62,
+   or base if c is not a valid digit. For bases up to 36 letters are
+   accepted in either case.
+*/
+static inline
+int nn_digit_value(char c, int base)
+{
+   int v;
+
+   if (c >= '0' && c <= '9')
+      v = c - '0';
+   else if (c >= 'A' && c <= 'Z')
+      v = c - 'A' + 10;
+   else if (c >= 'a' && c <= 'z')
+      v = c - 'a' + (base <= 36 ? 10 : 36);
+   else
+      return base;
+
+   return v < base ? v : base;
+}
+
+/*
+   Return a string representation of {a, m} in the given base, where
+   2 <= base <= 62. The user is responsible for freeing the string.
+   Bases which are powers of 2 use nn_get_str_pow2, base 10 uses 
+   nn_get_str and other bases nn_get_str_base_classical.
+*/
+char * nn_get_str_base(nn_src_t a, len_t m, int base);
+
+/*
+   Set {a, *len} to the natural number given by the string str in the
+   given base, where 2 <= base <= 62, and return the number of digits
+   read. Reading stops at the first character which is not a valid 
+   digit. If no digits are read, len is set to 0.
+*/
+size_t nn_set_str_base(nn_t a, len_t * len, const char * str, int base);
+
 /*
    Print {a, m} in decimal to stdout. If m == 0 then 0 is printed.
 */
@@ -302,6 +414,38 @@ word_t nn_sub_mc(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t bi);
 #define nn_sub_m(a, b, c, m) \
    nn_sub_mc(a, b, c, m, (word_t) 0)
 
+/*
+   Return a mask of all ones if cnd is nonzero, otherwise zero, without
+   branching on cnd.
+*/
+static inline
+word_t nn_cnd_mask(word_t cnd)
+{
+   return -((cnd | -cnd) >> (WORD_BITS - 1));
+}
+
+/*
+   If cnd is nonzero set a = b + c, otherwise set a = b, where b and c 
+   are both m words in length. Return any carry out. The sequence of
+   instructions and memory accesses does not depend on cnd or on the 
+   values of b and c.
+*/
+word_t nn_cnd_add(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd);
+
+/*
+   If cnd is nonzero set a = b - c, otherwise set a = b, where b and c 
+   are both m words in length. Return any borrow. The sequence of
+   instructions and memory accesses does not depend on cnd or on the 
+   values of b and c.
+*/
+word_t nn_cnd_sub(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd);
+
+/*
+   If cnd is nonzero swap {a, m} and {b, m}, otherwise leave them 
+   unchanged. Both are read and written in either case.
+*/
+void nn_cnd_swap(nn_t a, nn_t b, len_t m, word_t cnd);
+
 /*
    Set a = b + c + ci where b is bm words, c is cm words in length,
    bm >= cm and ci is a "carry in". We return the carry out. The carry-in 
@@ -474,6 +618,23 @@ word_t nn_mod1_preinv_c(nn_src_t a, len_t m, word_t d,
 #define nn_mod1_preinv(a, m, d, inv) \
    nn_mod1_preinv_c(a, m, d, inv, (word_t) 0)
 
+/*
+   Write the digits of {a, m} in base 2^k, most significant first and 
+   without leading zeroes, to str and return the number written. No
+   terminating null character is written. We require m > 0, a[m - 1] 
+   != 0 and 1 <= k <= 5. Each digit is sliced directly out of the bits
+   of a and hexadecimal output is table driven.
+*/
+size_t nn_get_str_pow2(char * str, nn_src_t a, len_t m, bits_t k);
+
+/*
+   Set a to the value of the first digits characters of str, which 
+   must be valid digits in base 2^k, and return its length in words,
+   normalised. We require 1 <= k <= 5. The output a requires space for
+   ceil(digits*k/WORD_BITS) words.
+*/
+len_t nn_set_str_pow2(nn_t a, const char * str, size_t digits, bits_t k);
+
 /**********************************************************************
  
     Comparison
@@ -608,6 +769,30 @@ word_t _nn_divapprox_helper(nn_t q, nn_t a, nn_src_t d, len_t s);
 */
 void nn_mul_classical(nn_t r, nn_src_t a, len_t m1, nn_src_t b, len_t m2);
 
+/*
+   Set {r, 2*m} = {a, m}^2. Each cross product a[i]*a[j] is computed
+   once and doubled. The output r may not alias a. We require m > 0.
+*/
+void nn_sqr_classical(nn_t r, nn_src_t a, len_t m);
+
+/*
+   Montgomery reduction. Set {r, n} = {t, 2*n}*B^(-n) mod {d, n}, fully
+   reduced, where d is odd and dinv = d[0]^(-1) mod B is computed with
+   precompute_hensel_inverse1. We require {t, 2*n} < d*B^n, which holds
+   for the product of two values reduced mod d. The input t is 
+   destroyed and r may alias t + n but not d.
+*/
+void nn_redc_classical(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                  hensel_preinv1_t dinv);
+
+/*
+   As per nn_redc_classical, but the final conditional subtraction is 
+   made with nn_cnd_sub, so that the sequence of instructions and 
+   memory accesses does not depend on the values of t and d.
+*/
+void nn_redc_sec_classical(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                  hensel_preinv1_t dinv);
+
 /*
    Set ov*B^m1 + {r, m1} to sum_{i + j < m1} a[i]*b[j]*B^{i + j}. In 
    other words, {r, m1} will be the low m1 words of the product 
@@ -700,6 +885,110 @@ len_t nn_gcd_lehmer(nn_t g, nn_t a, len_t m, nn_t b, len_t n);
 */
 len_t nn_xgcd_lehmer(nn_t g, nn_t v, nn_t a, len_t m, nn_t b, len_t n);
 
+/*
+   Write exactly the given number of decimal digits of {a, m} to str,
+   padding with leading zeroes if necessary. No terminating null 
+   character is written. We require a < 10^digits. The digits are 
+   produced DEC_WORD_DIGITS at a time by division by DEC_WORD_BASE 
+   with a precomputed inverse. The value of a is destroyed.
+*/
+void nn_get_str_classical(char * str, size_t digits, nn_t a, len_t m);
+
+/*
+   Set a to the natural number given by the first digits characters of
+   str, which must all be decimal digits, and return its length in 
+   words, normalised. The digits are consumed DEC_WORD_DIGITS at a time
+   with a single nn_mul1 and nn_add1 per chunk. The output a must have
+   space for the full, normalised result.
+*/
+len_t nn_set_str_classical(nn_t a, const char * str, size_t digits);
+
+/*
+   As per nn_get_str_classical but in the given base, where 2 <= base 
+   <= 62. The digits are produced in chunks of c at a time, where base^c
+   is the largest power of the base which fits in a word.
+*/
+void nn_get_str_base_classical(char * str, size_t digits, 
+                                          nn_t a, len_t m, int base);
+
+/*
+   As per nn_set_str_classical but in the given base, where 2 <= base 
+   <= 62. The characters must all be valid digits in the given base.
+*/
+len_t nn_set_str_base_classical(nn_t a, const char * str, 
+                                          size_t digits, int base);
+
+/**********************************************************************
+ 
+    Fixed length kernels
+
+**********************************************************************/
+
+/*
+   The largest length for which a fixed length kernel exists.
+*/
+#define NN_FIXED_MAX 32L
+
+/*
+   Fully unrolled kernels for each length N in {2, 3, 4, 6, 8, 12, 16, 
+   24, 32}, generated by macros in nn_fixed.c, e.g. nn_add_4, nn_mul_4x4,
+   nn_sqr_8 and nn_mont_mul_16:
+
+   nn_add_N(r, a, b) sets {r, N} = {a, N} + {b, N} and returns the 
+   carry, and nn_sub_N(r, a, b) sets {r, N} = {a, N} - {b, N} and 
+   returns the borrow. The output may alias either input.
+
+   nn_mul_NxN(r, a, b) sets {r, 2N} = {a, N}*{b, N} and nn_sqr_N(r, a) 
+   sets {r, 2N} = {a, N}^2. The output may not alias an input.
+
+   nn_redc_N(r, t, d, dinv) and nn_mont_mul_N(r, a, b, d, dinv) are as
+   per nn_redc_classical and nn_mont_mul with n = N.
+*/
+#define NN_FIXED_DECLS(N) \
+   word_t nn_add_##N(nn_t r, nn_src_t a, nn_src_t b); \
+   word_t nn_sub_##N(nn_t r, nn_src_t a, nn_src_t b); \
+   void nn_mul_##N##x##N(nn_t r, nn_src_t a, nn_src_t b); \
+   void nn_sqr_##N(nn_t r, nn_src_t a); \
+   void nn_redc_##N(nn_t r, nn_t t, nn_src_t d, hensel_preinv1_t dinv); \
+   void nn_mont_mul_##N(nn_t r, nn_src_t a, nn_src_t b, \
+                                      nn_src_t d, hensel_preinv1_t dinv);
+
+NN_FIXED_DECLS(2)
+NN_FIXED_DECLS(3)
+NN_FIXED_DECLS(4)
+NN_FIXED_DECLS(6)
+NN_FIXED_DECLS(8)
+NN_FIXED_DECLS(12)
+NN_FIXED_DECLS(16)
+NN_FIXED_DECLS(24)
+NN_FIXED_DECLS(32)
+
+/*
+   As per nn_mul_classical with m1 = m2 = m, using the fixed length 
+   kernel for m if there is one.
+*/
+void nn_mul_fixed(nn_t r, nn_src_t a, nn_src_t b, len_t m);
+
+/*
+   As per nn_sqr_classical, using the fixed length kernel for m if 
+   there is one.
+*/
+void nn_sqr_fixed(nn_t r, nn_src_t a, len_t m);
+
+/*
+   As per nn_redc_classical, using the fixed length kernel for n if 
+   there is one.
+*/
+void nn_redc_fixed(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                  hensel_preinv1_t dinv);
+
+/*
+   As per nn_mont_mul, using the fixed length kernels for n if there 
+   are some.
+*/
+void nn_mont_mul_fixed(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, 
+                                         len_t n, hensel_preinv1_t dinv);
+
 /**********************************************************************
  
     Subquadratic arithmetic functions
@@ -791,6 +1080,63 @@ void nn_divrem_divconquer_preinv_c(nn_t q, nn_t a, len_t m, nn_src_t d,
 void nn_div_divconquer_preinv_c(nn_t q, nn_t a, len_t m, nn_src_t d, 
                                         len_t n, preinv2_t dinv, word_t ci);
 
+/*
+   As per nn_get_str_classical, but a is split in two by division by
+   a power 10^(DEC_WORD_DIGITS*2^k) of roughly half its size and each
+   half is converted recursively, until the pieces are smaller than
+   GET_STR_DIVCONQUER_CUTOFF words. The powers are computed once by
+   repeated squaring. The value of a is destroyed.
+*/
+void nn_get_str_divconquer(char * str, size_t digits, nn_t a, len_t m);
+
+/*
+   Set pow[i] = 10^(DEC_WORD_DIGITS*2^i), of plen[i] words, for i = 0, 1,
+   ... while 2*plen[i] <= m + 1 and return the final value of i. The
+   powers are stored in the buffer t, which must have space for 2*m + 2
+   words.
+*/
+len_t _nn_dec_powers(nn_t * pow, len_t * plen, nn_t t, len_t m);
+
+/*
+   Write digits decimal digits of {a, m} to str, where pow[i] is
+   10^(DEC_WORD_DIGITS*2^i) of plen[i] words, for 0 <= i <= k. The 
+   value of a is destroyed.
+*/
+void _nn_get_str_divconquer(char * str, size_t digits, nn_t a, len_t m,
+                            nn_t * pow, len_t * plen, len_t k);
+
+#if WANT_THREADS
+
+/*
+   As per nn_get_str_divconquer, but the two halves at each level of the
+   recursion are converted in parallel, using at most the given number 
+   of threads in total. If a thread cannot be created, the work is done 
+   in the calling thread. Only available if bsdnt was configured with
+   --enable-threads.
+*/
+void nn_get_str_divconquer_threaded(char * str, size_t digits, 
+                                           nn_t a, len_t m, long threads);
+
+#endif
+
+/*
+   As per nn_set_str_classical, but the low digits, corresponding to a 
+   power 10^(DEC_WORD_DIGITS*2^k) of roughly half the size of the 
+   result, and the remaining high digits are converted recursively and
+   combined with a single nn_mul, until fewer than 
+   SET_STR_DIVCONQUER_CUTOFF words worth of digits remain.
+*/
+len_t nn_set_str_divconquer(nn_t a, const char * str, size_t digits);
+
+/*
+   Write the decimal representation of {a, m} to the stream f, with no
+   leading zeroes, and return the number of characters written. The
+   digits are generated as per nn_get_str_divconquer, most significant
+   first, and each block is written as soon as it is converted. We 
+   require m > 0 and a[m - 1] != 0. The value of a is destroyed.
+*/
+size_t nn_out_str_divconquer(FILE * f, nn_t a, len_t m);
+
 /**********************************************************************
  
     Tuned (best-of-breed) arithmetic functions
@@ -811,6 +1157,12 @@ void nn_mul_m(nn_t p, nn_src_t a, nn_src_t b, len_t m);
 */
 void nn_mul(nn_t p, nn_src_t a, len_t m, nn_src_t b, len_t n);
 
+/*
+   Set {p, 2*m} = {a, m}^2. The output p may not alias a. We require
+   m > 0.
+*/
+void nn_sqr(nn_t p, nn_src_t a, len_t m);
+
 /*
    As per nn_mullow_classical, but with m = n.
 */
@@ -872,6 +1224,145 @@ void nn_divrem(nn_t q, nn_t a, len_t m, nn_src_t d, len_t n);
 */
 void nn_div(nn_t q, nn_t a, len_t m, nn_src_t d, len_t n);
 
+/*
+   Set {r, m} to the inverse of {a, m} modulo B^m, i.e. a value such
+   that a*r = 1 mod B^m. We require a to be odd and m > 0. The inverse 
+   is computed by Newton (Hensel) iteration, doubling the precision
+   at each step. The output r may not alias a.
+*/
+void nn_invert_hensel(nn_t r, nn_src_t a, len_t m);
+
+/*
+   If {a, m} is invertible modulo {d, n}, set {r, n} to the inverse
+   and return 1, otherwise return 0 and leave r unmodified. We require 
+   n >= m >= 0, {a, m} < {d, n} and that d[n - 1] is nonzero. If d is
+   1 then r is set to 0 and 1 is returned. Only the required cofactor 
+   is computed. Single word odd moduli use a binary extended gcd and 
+   moduli which are powers of 2 use nn_invert_hensel. The output r may
+   alias a, but not d.
+*/
+int nn_invmod(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t n);
+
+/*
+   Set r[i] = {a, m} mod d[i] for each of the num nonzero word moduli
+   {d, num}. A subproduct tree of the moduli is formed and a is 
+   reduced down it (a remainder tree) until the remainders are at
+   most MULTI_MOD_CUTOFF words, after which each remainder is reduced
+   by the moduli below it using a precomputed mod_preinv1_t. For at
+   most MULTI_MOD_CUTOFF moduli a is simply reduced by each in turn.
+   We require m >= 0 and num > 0. The output r may not alias a or d.
+*/
+void nn_multi_mod(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t num);
+
+/*
+   Set {r, n} = {a, m} mod (2^k - c), where n = ceil(k/WORD_BITS). The 
+   bits above 2^k are repeatedly folded down, using 2^k = c mod 2^k - c,
+   with nn_shr_c and nn_addmul1_c, so that no division is needed. Each
+   fold removes about k - log2(c) bits, so this is intended for small c
+   and m <= 2n, e.g. a product of two reduced values. We require k > 1
+   and c < 2^(k - 1). The output may alias a.
+*/
+void nn_mod_2exp_minus_c(nn_t r, nn_src_t a, len_t m, bits_t k, word_t c);
+
+/*
+   Set {r, n} = ((a^2 - d)^2 - d ...) mod (2^k - c), with iter squarings
+   of {a, n}, where n = ceil(k/WORD_BITS), each reduced with 
+   nn_mod_2exp_minus_c. With c = 1, d = 2 and a = 4 this is the 
+   Lucas-Lehmer iteration. We require a < 2^k - c, d < 2^k - c and the
+   requirements of nn_mod_2exp_minus_c. The output may alias a.
+*/
+void nn_sqrsub_mod_2exp_minus_c(nn_t r, nn_src_t a, bits_t k, word_t c, 
+                                                   word_t d, len_t iter);
+
+/*
+   Normalise {r, n + 1} modulo B^n + 1, where the top word r[n] is
+   treated as a signed word, as left by additions and subtractions of 
+   normalised values, e.g. in an FFT butterfly. On return r[n] is 1 
+   only if {r, n} is zero, i.e. the value is B^n = -1.
+*/
+void nn_normmod_2expp1(nn_t r, len_t n);
+
+/*
+   Set {r, n + 1} = {a, n + 1}*{b, n + 1} mod B^n + 1, where the inputs
+   are normalised as per nn_normmod_2expp1 and so is the output. For 
+   even n of at least MULMOD_2EXPP1_KARA_CUTOFF words, the product is
+   the negacyclic convolution of the halves of a and b, computed with
+   three products of n/2 words by Karatsuba's method, otherwise the 
+   full product is folded using B^n = -1. Either way no division is 
+   done. The output may not alias a or b. We require n > 0.
+*/
+void nn_mulmod_2expp1(nn_t r, nn_src_t a, nn_src_t b, len_t n);
+
+/*
+   Set {s, n} to the integer square root floor(sqrt(a)) of {a, m}, 
+   where n = ceil(m/2), and set r to the remainder a - s^2, returning 
+   its normalised length. The remainder is at most 2s and r requires 
+   space for n + 1 words. This is Zimmermann's Karatsuba square root: 
+   a is shifted so that its top word is at least B/4 and has an even
+   number of words, the square root of the top half is found 
+   recursively and the next n/2 words of the root are the quotient of 
+   the remainder by twice that root, computed with nn_divrem, followed
+   by at most one correction. The cost is a small multiple of a 
+   multiplication. We require m > 0 and a[m - 1] != 0. Neither s nor r 
+   may alias a.
+*/
+len_t nn_sqrtrem(nn_t s, nn_t r, nn_src_t a, len_t m);
+
+/*
+   Set {r, n} = {a, m}*B^n mod {d, n}, i.e. the Montgomery form of a. We
+   require n > 0 and d[n - 1] != 0. Any m >= 0 is allowed. The output
+   may not alias a or d.
+*/
+void nn_mont_set(nn_t r, nn_src_t a, len_t m, nn_src_t d, len_t n);
+
+/*
+   Set {r, n} = {a, n}*{b, n}*B^(-n) mod {d, n}, the Montgomery product
+   of a and b, where d is odd and dinv is computed with 
+   precompute_hensel_inverse1. We require {a, n}*{b, n} < d*B^n, e.g.
+   a and b reduced mod d. The output may alias a or b.
+*/
+void nn_mont_mul(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n, 
+                                                  hensel_preinv1_t dinv);
+
+/*
+   As per nn_mont_mul, but using the caller supplied scratch space 
+   {t, 2*n} instead of allocating it on each call, for use in loops.
+   The scratch space may not alias r, a, b or d.
+*/
+void nn_mont_mul_tmp(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n, 
+                                          hensel_preinv1_t dinv, nn_t t);
+
+/*
+   Set {r, n} = {a, n}*B^(-n) mod {d, n}, converting a out of Montgomery
+   form. The requirements are as for nn_mont_mul and r may alias a.
+*/
+void nn_mont_get(nn_t r, nn_src_t a, nn_src_t d, len_t n, 
+                                                  hensel_preinv1_t dinv);
+
+/*
+   Set {r, n} = {a, m}^{e, en} mod {d, n}. Exponents are scanned from the
+   top bit with a sliding window whose size grows with the length of e, 
+   from a table of odd powers of a. For odd d, arithmetic is done in 
+   Montgomery form with nn_redc_classical, otherwise each product is 
+   reduced with nn_divrem. The output r may not alias any input. We 
+   require n > 0 and d[n - 1] != 0. Any m >= 0 is allowed.
+*/
+void nn_powm(nn_t r, nn_src_t a, len_t m, nn_src_t e, len_t en, 
+                                                   nn_src_t d, len_t n);
+
+/*
+   As per nn_powm, but intended for secret exponents. The exponent is 
+   scanned in fixed windows over all en*WORD_BITS bits, each window is 
+   looked up by a masked scan of the whole table, and only the
+   classical multiplication, squaring and nn_redc_sec_classical are 
+   used, so that timing and memory accesses do not depend on e. Only
+   en, d and n are treated as public. If m > n the base is first 
+   reduced with nn_divrem, which is not side channel resistant. We 
+   require d to be odd.
+*/
+void nn_powm_sec(nn_t r, nn_src_t a, len_t m, nn_src_t e, len_t en, 
+                                                    nn_src_t d, len_t n);
+
 #define nn_gcd(g, a, m, b, n) \
    nn_gcd_lehmer(g, a, m, b, n)
 
@@ -0,0 +1,3 @@
+#ifndef nn_H
+#define nn_H
+#endif
@@ -0,0 +1,305 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "nn.h"
+#include "nn_fixed_arch.h"
+
+/*
+   The kernels below are generated by macros. NN_REPAn(X, i, N) expands
+   to X(i, N) X(i + 1, N) ... X(i + n - 1, N), so that every loop over
+   the n words of an operand is fully unrolled and every index is a
+   constant. A second identical family NN_REPBn is used for inner loops,
+   since a macro cannot be expanded again inside its own expansion.
+*/
+
+#define NN_REPA1(X, i, N) X((i), N)
+#define NN_REPA2(X, i, N) NN_REPA1(X, i, N) NN_REPA1(X, (i) + 1, N)
+#define NN_REPA3(X, i, N) NN_REPA2(X, i, N) NN_REPA1(X, (i) + 2, N)
+#define NN_REPA4(X, i, N) NN_REPA2(X, i, N) NN_REPA2(X, (i) + 2, N)
+#define NN_REPA6(X, i, N) NN_REPA3(X, i, N) NN_REPA3(X, (i) + 3, N)
+#define NN_REPA8(X, i, N) NN_REPA4(X, i, N) NN_REPA4(X, (i) + 4, N)
+#define NN_REPA12(X, i, N) NN_REPA6(X, i, N) NN_REPA6(X, (i) + 6, N)
+#define NN_REPA16(X, i, N) NN_REPA8(X, i, N) NN_REPA8(X, (i) + 8, N)
+#define NN_REPA24(X, i, N) NN_REPA12(X, i, N) NN_REPA12(X, (i) + 12, N)
+#define NN_REPA32(X, i, N) NN_REPA16(X, i, N) NN_REPA16(X, (i) + 16, N)
+
+#define NN_REPB1(X, i, N) X((i), N)
+#define NN_REPB2(X, i, N) NN_REPB1(X, i, N) NN_REPB1(X, (i) + 1, N)
+#define NN_REPB3(X, i, N) NN_REPB2(X, i, N) NN_REPB1(X, (i) + 2, N)
+#define NN_REPB4(X, i, N) NN_REPB2(X, i, N) NN_REPB2(X, (i) + 2, N)
+#define NN_REPB6(X, i, N) NN_REPB3(X, i, N) NN_REPB3(X, (i) + 3, N)
+#define NN_REPB8(X, i, N) NN_REPB4(X, i, N) NN_REPB4(X, (i) + 4, N)
+#define NN_REPB12(X, i, N) NN_REPB6(X, i, N) NN_REPB6(X, (i) + 6, N)
+#define NN_REPB16(X, i, N) NN_REPB8(X, i, N) NN_REPB8(X, (i) + 8, N)
+#define NN_REPB24(X, i, N) NN_REPB12(X, i, N) NN_REPB12(X, (i) + 12, N)
+#define NN_REPB32(X, i, N) NN_REPB16(X, i, N) NN_REPB16(X, (i) + 16, N)
+
+/* r[j] = a[j] + b[j] + ci */
+#define NN_ADD_STEP(j, N) \
+   s = (dword_t) a[j] + (dword_t) b[j] + (dword_t) ci; \
+   r[j] = (word_t) s; \
+   ci = (word_t) (s >> WORD_BITS);
+
+/* r[j] = a[j] - b[j] - ci */
+#define NN_SUB_STEP(j, N) \
+   s = (dword_t) a[j] - (dword_t) b[j] - (dword_t) ci; \
+   r[j] = (word_t) s; \
+   ci = -(word_t) (s >> WORD_BITS);
+
+#define NN_ZERO_STEP(j, N) \
+   r[j] = 0;
+
+/* r[i + j] += a[j]*b[i] + ci */
+#define NN_MUL_STEP(j, N) \
+   s = (dword_t) a[j] * (dword_t) b[i_] + (dword_t) r[i_ + (j)] \
+                                                      + (dword_t) ci; \
+   r[i_ + (j)] = (word_t) s; \
+   ci = (word_t) (s >> WORD_BITS);
+
+#define NN_MUL_ROW(i, N) \
+   { \
+      const len_t i_ = (i); \
+      ci = 0; \
+      NN_REPB##N(NN_MUL_STEP, 0, N) \
+      r[i_ + N] = ci; \
+   }
+
+/* r[i + j] += a[j]*a[i] + ci for j > i only */
+#define NN_SQR_STEP(j, N) \
+   if ((j) > i_) \
+   { \
+      s = (dword_t) a[j] * (dword_t) a[i_] + (dword_t) r[i_ + (j)] \
+                                                      + (dword_t) ci; \
+      r[i_ + (j)] = (word_t) s; \
+      ci = (word_t) (s >> WORD_BITS); \
+   }
+
+#define NN_SQR_ROW(i, N) \
+   { \
+      const len_t i_ = (i); \
+      ci = 0; \
+      NN_REPB##N(NN_SQR_STEP, 0, N) \
+      r[i_ + N] = ci; \
+   }
+
+/* shift r left by one bit, from the bottom */
+#define NN_SHL1_STEP(j, N) \
+   hi = r[j] >> (WORD_BITS - 1); \
+   r[j] = (r[j] << 1) | ci; \
+   ci = hi;
+
+/* add a[j]^2 to r[2j], r[2j + 1] */
+#define NN_DIAG_STEP(j, N) \
+   s = (dword_t) a[j] * (dword_t) a[j] + (dword_t) r[2*(j)] \
+                                                      + (dword_t) ci; \
+   r[2*(j)] = (word_t) s; \
+   s = (dword_t) r[2*(j) + 1] + (s >> WORD_BITS); \
+   r[2*(j) + 1] = (word_t) s; \
+   ci = (word_t) (s >> WORD_BITS);
+
+/* t[i + j] += d[j]*q + ci */
+#define NN_REDC_STEP(j, N) \
+   s = (dword_t) d[j] * (dword_t) q + (dword_t) t[i_ + (j)] \
+                                                      + (dword_t) ci; \
+   t[i_ + (j)] = (word_t) s; \
+   ci = (word_t) (s >> WORD_BITS);
+
+/* 
+   clear t[i] with a multiple of d*B^i, saving the carry out, which
+   belongs at t[i + N], in t[i] 
+*/
+#define NN_REDC_ROW(i, N) \
+   { \
+      const len_t i_ = (i); \
+      const word_t q = -(t[i_]*dinv); \
+      ci = 0; \
+      NN_REPB##N(NN_REDC_STEP, 0, N) \
+      t[i_] = ci; \
+   }
+
+/* r[j] = t[N + j] + t[j] + ci */
+#define NN_REDC_ADD_STEP(j, N) \
+   s = (dword_t) t[N + (j)] + (dword_t) t[j] + (dword_t) ci; \
+   r[j] = (word_t) s; \
+   ci = (word_t) (s >> WORD_BITS);
+
+/* u[j] = r[j] - d[j] - bi */
+#define NN_REDC_SUB_STEP(j, N) \
+   s = (dword_t) r[j] - (dword_t) d[j] - (dword_t) bi; \
+   u[j] = (word_t) s; \
+   bi = -(word_t) (s >> WORD_BITS);
+
+#define NN_COPY_STEP(j, N) \
+   r[j] = u[j];
+
+#define NN_FIXED_KERNELS(N) \
+\
+word_t nn_add_##N(nn_t r, nn_src_t a, nn_src_t b) \
+{ \
+   dword_t s; \
+   word_t ci = 0; \
+   NN_REPA##N(NN_ADD_STEP, 0, N) \
+   return ci; \
+} \
+\
+word_t nn_sub_##N(nn_t r, nn_src_t a, nn_src_t b) \
+{ \
+   dword_t s; \
+   word_t ci = 0; \
+   NN_REPA##N(NN_SUB_STEP, 0, N) \
+   return ci; \
+} \
+\
+void nn_mul_##N##x##N(nn_t r, nn_src_t a, nn_src_t b) \
+{ \
+   dword_t s; \
+   word_t ci; \
+   NN_REPA##N(NN_ZERO_STEP, 0, N) \
+   NN_REPA##N(NN_MUL_ROW, 0, N) \
+} \
+\
+void nn_sqr_##N(nn_t r, nn_src_t a) \
+{ \
+   dword_t s; \
+   word_t ci, hi; \
+   NN_REPA##N(NN_ZERO_STEP, 0, N) \
+   NN_REPA##N(NN_SQR_ROW, 0, N) \
+   ci = 0; \
+   NN_REPA##N(NN_SHL1_STEP, 0, N) \
+   NN_REPA##N(NN_SHL1_STEP, N, N) \
+   ci = 0; \
+   NN_REPA##N(NN_DIAG_STEP, 0, N) \
+} \
+\
+void nn_redc_##N(nn_t r, nn_t t, nn_src_t d, hensel_preinv1_t dinv) \
+{ \
+   dword_t s; \
+   word_t ci, bi = 0, u[N]; \
+   NN_REPA##N(NN_REDC_ROW, 0, N) \
+   ci = 0; \
+   NN_REPA##N(NN_REDC_ADD_STEP, 0, N) \
+   NN_REPA##N(NN_REDC_SUB_STEP, 0, N) \
+   if (ci || !bi) \
+   { \
+      NN_REPA##N(NN_COPY_STEP, 0, N) \
+   } \
+} \
+\
+void nn_mont_mul_##N(nn_t r, nn_src_t a, nn_src_t b, \
+                                     nn_src_t d, hensel_preinv1_t dinv) \
+{ \
+   word_t t[2*N]; \
+   if (a == b) \
+      nn_sqr_##N(t, a); \
+   else \
+      nn_mul_##N##x##N(t, a, b); \
+   nn_redc_##N(r, t, d, dinv); \
+}
+
+NN_FIXED_KERNELS(2)
+NN_FIXED_KERNELS(3)
+NN_FIXED_KERNELS(4)
+NN_FIXED_KERNELS(6)
+NN_FIXED_KERNELS(8)
+NN_FIXED_KERNELS(12)
+NN_FIXED_KERNELS(16)
+NN_FIXED_KERNELS(24)
+NN_FIXED_KERNELS(32)
+
+/*
+   The dispatchers below select a kernel with a switch on the length.
+*/
+
+#define NN_FIXED_CASES(X) \
+   X(2) X(3) X(4) X(6) X(8) X(12) X(16) X(24) X(32)
+
+void nn_mul_fixed(nn_t r, nn_src_t a, nn_src_t b, len_t m)
+{
+#define NN_MUL_CASE(N) case N: nn_mul_##N##x##N(r, a, b); return;
+   switch (m)
+   {
+      NN_FIXED_CASES(NN_MUL_CASE)
+   default:
+      nn_mul_classical(r, a, m, b, m);
+   }
+#undef NN_MUL_CASE
+}
+
+void nn_sqr_fixed(nn_t r, nn_src_t a, len_t m)
+{
+#define NN_SQR_CASE(N) case N: nn_sqr_##N(r, a); return;
+   switch (m)
+   {
+      NN_FIXED_CASES(NN_SQR_CASE)
+   default:
+      nn_sqr_classical(r, a, m);
+   }
+#undef NN_SQR_CASE
+}
+
+void nn_redc_fixed(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                   hensel_preinv1_t dinv)
+{
+#define NN_REDC_CASE(N) case N: nn_redc_##N(r, t, d, dinv); return;
+   switch (n)
+   {
+      NN_FIXED_CASES(NN_REDC_CASE)
+   default:
+      nn_redc_classical(r, t, d, n, dinv);
+   }
+#undef NN_REDC_CASE
+}
+
+void nn_mont_mul_fixed(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, 
+                                         len_t n, hensel_preinv1_t dinv)
+{
+   nn_t t;
+   TMP_INIT;
+
+#define NN_MONT_MUL_CASE(N) case N: nn_mont_mul_##N(r, a, b, d, dinv); return;
+   switch (n)
+   {
+      NN_FIXED_CASES(NN_MONT_MUL_CASE)
+   default:
+      break;
+   }
+#undef NN_MONT_MUL_CASE
+
+   TMP_START;
+
+   t = (nn_t) TMP_ALLOC(2*n);
+
+   if (a == b)
+      nn_sqr_fixed(t, a, n);
+   else
+      nn_mul_fixed(t, a, b, n);
+
+   nn_redc_classical(r, t, d, n, dinv);
+
+   TMP_END;
+}
@@ -0,0 +1,3 @@
+#ifndef nn_fixed_H
+#define nn_fixed_H
+#endif
@@ -27,6 +27,7 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 #include "nn.h"
 #include "nn_linear_arch.h"
 
@@ -242,6 +243,66 @@ word_t nn_sub_mc(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t bi)
 
 #endif
 
+#ifndef HAVE_ARCH_nn_cnd_add
+
+word_t nn_cnd_add(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd)
+{
+   const word_t mask = nn_cnd_mask(cnd);
+   word_t ci = 0;
+   dword_t t;
+   long i;
+
+   for (i = 0; i < m; i++)
+   {
+      t = (dword_t) b[i] + (dword_t) (c[i] & mask) + (dword_t) ci;
+      a[i] = (word_t) t;
+      ci = (t >> WORD_BITS);
+   }
+
+   return ci;
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_cnd_sub
+
+word_t nn_cnd_sub(nn_t a, nn_src_t b, nn_src_t c, len_t m, word_t cnd)
+{
+   const word_t mask = nn_cnd_mask(cnd);
+   word_t bi = 0;
+   dword_t t;
+   long i;
+
+   for (i = 0; i < m; i++)
+   {
+      t = (dword_t) b[i] - (dword_t) (c[i] & mask) - (dword_t) bi;
+      a[i] = (word_t) t;
+      bi = -(t >> WORD_BITS);
+   }
+
+   return bi;
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_cnd_swap
+
+void nn_cnd_swap(nn_t a, nn_t b, len_t m, word_t cnd)
+{
+   const word_t mask = nn_cnd_mask(cnd);
+   word_t t;
+   long i;
+
+   for (i = 0; i < m; i++)
+   {
+      t = (a[i] ^ b[i]) & mask;
+      a[i] ^= t;
+      b[i] ^= t;
+   }
+}
+
+#endif
+
 #ifndef HAVE_ARCH_nn_shl_c
 
 word_t nn_shl_c(nn_t a, nn_src_t b, len_t m, bits_t bits, word_t ci)
@@ -552,3 +613,140 @@ int nn_cmp_m(nn_src_t a, nn_src_t b, len_t m)
 }
 
 #endif
+
+/* two character hexadecimal representations of the bytes 0 to 255 */
+static const char _nn_hex_enc[] =
+   "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+   "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+   "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+   "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+   "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+   "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+   "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+   "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/* values of hexadecimal characters, 16 for anything else */
+static const unsigned char _nn_hex_dec[256] = 
+{
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 16, 16, 16, 16, 16, 16,
+   16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16
+};
+
+#ifndef HAVE_ARCH_nn_get_str_pow2
+
+size_t nn_get_str_pow2(char * str, nn_src_t a, len_t m, bits_t k)
+{
+   word_t mask = (WORD(1) << k) - 1, v;
+   bits_t bits, pos, off;
+   size_t i = 0, digits;
+   len_t w;
+   int j;
+
+   ASSERT(m > 0 && a[m - 1] != 0);
+   ASSERT(k >= 1 && k <= 5);
+
+   if (k == 4) /* hexadecimal, a byte at a time */
+   {
+      v = a[m - 1];
+      
+      for (j = (WORD_BITS - high_zero_bits(v) + 3)/4; j > 0; j--)
+         str[i++] = nn_digit_char((v >> (4*(j - 1))) & 15, 16);
+
+      for (w = m - 2; w >= 0; w--)
+      {
+         for (j = WORD_BITS - 8; j >= 0; j -= 8, i += 2)
+            memcpy(str + i, _nn_hex_enc + 2*((a[w] >> j) & 255), 2);
+      }
+
+      return i;
+   }
+
+   bits = m*WORD_BITS - high_zero_bits(a[m - 1]);
+   digits = (bits + k - 1)/k;
+
+   /* extract k bits at a time, most significant digit first */
+   for (i = digits; i > 0; i--)
+   {
+      pos = (i - 1)*k;
+      w = pos / WORD_BITS;
+      off = pos % WORD_BITS;
+
+      v = a[w] >> off;
+      if (off + k > WORD_BITS && w + 1 < m)
+         v |= a[w + 1] << (WORD_BITS - off);
+      
+      *str++ = nn_digit_char(v & mask, 1 << k);
+   }
+
+   return digits;
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_set_str_pow2
+
+len_t nn_set_str_pow2(nn_t a, const char * str, size_t digits, bits_t k)
+{
+   size_t i, j, c = WORD_BITS/4;
+   word_t acc = 0, v;
+   bits_t pos = 0;
+   len_t m = 0;
+
+   ASSERT(k >= 1 && k <= 5);
+
+   if (k == 4) /* hexadecimal, a word at a time */
+   {
+      for (i = digits; i >= c; i -= c)
+      {
+         for (j = i - c, acc = 0; j < i; j++)
+            acc = (acc << 4) | _nn_hex_dec[(unsigned char) str[j]];
+         
+         a[m++] = acc;
+      }
+
+      for (j = 0, acc = 0; j < i; j++)
+         acc = (acc << 4) | _nn_hex_dec[(unsigned char) str[j]];
+      
+      if (i) 
+         a[m++] = acc;
+
+      return nn_normalise(a, m);
+   }
+
+   /* insert k bits at a time, least significant digit first */
+   for (i = digits; i > 0; i--)
+   {
+      v = (word_t) nn_digit_value(str[i - 1], 1 << k);
+      
+      acc |= v << pos;
+      pos += k;
+
+      if (pos >= WORD_BITS)
+      {
+         a[m++] = acc;
+         pos -= WORD_BITS;
+         acc = pos ? v >> (k - pos) : 0;
+      }
+   }
+
+   if (acc)
+      a[m++] = acc;
+
+   return nn_normalise(a, m);
+}
+
+#endif
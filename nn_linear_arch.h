@@ -0,0 +1,3 @@
+#ifndef nn_linear_H
+#define nn_linear_H
+#endif
@@ -51,6 +51,89 @@ void nn_mul_classical(nn_t r, nn_src_t a, len_t m1,
 
 #endif
 
+#ifndef HAVE_ARCH_nn_sqr_classical
+
+void nn_sqr_classical(nn_t r, nn_src_t a, len_t m)
+{
+   dword_t p, s;
+   word_t c = 0;
+   len_t i;
+
+   ASSERT(r != a);
+   ASSERT(m > 0);
+
+   /* cross products a[i]*a[j] for i < j */
+   r[0] = 0;
+   r[m] = nn_mul1(r + 1, a + 1, m - 1, a[0]);
+
+   for (i = 1; i < m - 1; i++)
+      r[m + i] = nn_addmul1(r + 2*i + 1, a + i + 1, m - i - 1, a[i]);
+
+   r[2*m - 1] = nn_shl(r + 1, r + 1, 2*m - 2, 1);
+
+   /* diagonal terms */
+   for (i = 0; i < m; i++)
+   {
+      p = (dword_t) a[i] * (dword_t) a[i];
+      s = (dword_t) r[2*i] + (dword_t) (word_t) p + (dword_t) c;
+      r[2*i] = (word_t) s;
+      s = (dword_t) r[2*i + 1] + (p >> WORD_BITS) + (s >> WORD_BITS);
+      r[2*i + 1] = (word_t) s;
+      c = (word_t) (s >> WORD_BITS);
+   }
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_redc_classical
+
+void nn_redc_classical(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                   hensel_preinv1_t dinv)
+{
+   word_t ci;
+   len_t i;
+
+   ASSERT(d[0] & 1);
+   ASSERT(n > 0);
+
+   /* 
+      clear t[i] by adding a multiple of d*B^i, the carry out of which
+      belongs at t[n + i], but is saved in t[i] and added at the end
+   */
+   for (i = 0; i < n; i++)
+      t[i] = nn_addmul1(t + i, d, n, -(t[i]*dinv));
+
+   ci = nn_add_m(r, t + n, t, n);
+
+   if (ci || nn_cmp_m(r, d, n) >= 0)
+      nn_sub_m(r, r, d, n);
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_redc_sec_classical
+
+void nn_redc_sec_classical(nn_t r, nn_t t, nn_src_t d, len_t n, 
+                                                   hensel_preinv1_t dinv)
+{
+   word_t ci, bi;
+   len_t i;
+
+   ASSERT(d[0] & 1);
+   ASSERT(n > 0);
+
+   for (i = 0; i < n; i++)
+      t[i] = nn_addmul1(t + i, d, n, -(t[i]*dinv));
+
+   ci = nn_add_m(r, t + n, t, n);
+
+   /* subtract d if there was a carry or r >= d, computed without branches */
+   bi = nn_sub_m(t, r, d, n);
+   nn_cnd_sub(r, r, d, n, ci | (bi ^ 1));
+}
+
+#endif
+
 #ifndef HAVE_ARCH_nn_mullow_classical
 
 void nn_mullow_classical(nn_t ov, nn_t r, nn_src_t a, len_t m1, 
@@ -731,77 +814,147 @@ len_t nn_gcd_lehmer(nn_t g, nn_t a, len_t m, nn_t b, len_t n)
 
 #endif
 
-#ifndef HAVE_ARCH_nn_get_str
+#ifndef HAVE_ARCH_nn_get_str_classical
 
-char * nn_get_str(nn_src_t a, len_t m)
+void nn_get_str_classical(char * str, size_t digits, nn_t a, len_t m)
 {
-   /* 9.63... is log_10(2^32) */
-   size_t i = 0, j;
-   size_t digits = (long) ceil(m * 9.632959861247398 * (WORD_BITS/32)) + (m == 0);
-   char * str = (char *) malloc(digits + 1);
-   word_t ci, d = 10UL << (WORD_BITS - 4);
-   nn_t q1, q2, t;
-   TMP_INIT;
+   bits_t norm = high_zero_bits(DEC_WORD_BASE);
+   word_t d = DEC_WORD_BASE << norm, r;
+   preinv1_t inv = precompute_inverse1(d);
+   size_t i = digits;
+   int j;
+
+   m = nn_normalise(a, m);
 
-   if (m == 0)
-      str[0] = '0';
-   else 
+   /* strip off DEC_WORD_DIGITS digits at a time, least significant first */
+   while (m > 0 && i > 0)
    {
-      TMP_START;
-      q1 = (nn_t) TMP_ALLOC(m);
-      q2 = (nn_t) TMP_ALLOC(m);
-      nn_copy(q1, a, m);
+      if (norm)
+      {
+         r = nn_shl(a, a, m, norm);
+         r = nn_divrem1_preinv_c(a, a, m, d, inv, r) >> norm;
+      } else
+         r = nn_divrem1_preinv(a, a, m, d, inv);
+      
+      m = nn_normalise(a, m);
 
-      /* compute digits in reverse order */
-      for (i = digits; m > 0; i--) 
+      for (j = 0; j < DEC_WORD_DIGITS && i > 0; j++)
       {
-         ci = nn_shl(q1, q1, m, WORD_BITS - 4);
-         str[i - 1] = 48 + (char) (nn_divrem1_simple_c(q2, q1, m, d, ci) >> (WORD_BITS - 4));
-         t = q1; q1 = q2; q2 = t;
-         m = nn_normalise(q1, m);
+         str[--i] = '0' + (char) (r % 10);
+         r /= 10;
       }
+   }
+
+   while (i > 0)
+      str[--i] = '0';
+}
+
+#endif
+
+#ifndef HAVE_ARCH_nn_set_str_classical
+
+len_t nn_set_str_classical(nn_t a, const char * str, size_t digits)
+{
+   len_t m = 0;
+   size_t i, j, c;
+   word_t ci, w, p;
+
+   /* consume DEC_WORD_DIGITS digits at a time, the first chunk short */
+   for (i = 0; i < digits; i += c)
+   {
+      c = (i == 0 && digits % DEC_WORD_DIGITS) ? 
+                      digits % DEC_WORD_DIGITS : DEC_WORD_DIGITS;
+      
+      for (j = 0, w = 0, p = 1; j < c; j++, p *= 10)
+         w = 10*w + (word_t) (str[i + j] - '0');
+
+      ci = nn_mul1(a, a, m, p);
+      ci += nn_add1(a, a, m, w);
+      if (ci) a[m++] = ci;
+   }
+
+   return m;
+}
+
+#endif
 
-      TMP_END;
+#ifndef HAVE_ARCH_nn_get_str_base_classical
 
-      /* didn't get the right number of digits, shift */
-      if (i) 
+void nn_get_str_base_classical(char * str, size_t digits, 
+                                          nn_t a, len_t m, int base)
+{
+   word_t d = base, r;
+   bits_t norm;
+   preinv1_t inv;
+   size_t i = digits;
+   int j, c = 1;
+
+   /* d = base^c is the largest power of base which fits in a word */
+   while (d <= ((word_t) -1)/base)
+   {
+      d *= base;
+      c++;
+   }
+
+   norm = high_zero_bits(d);
+   d <<= norm;
+   inv = precompute_inverse1(d);
+
+   m = nn_normalise(a, m);
+
+   while (m > 0 && i > 0)
+   {
+      if (norm)
       {
-         for (j = i; j < digits; j++)
-            str[j - i] = str[j];
+         r = nn_shl(a, a, m, norm);
+         r = nn_divrem1_preinv_c(a, a, m, d, inv, r) >> norm;
+      } else
+         r = nn_divrem1_preinv(a, a, m, d, inv);
+      
+      m = nn_normalise(a, m);
+
+      for (j = 0; j < c && i > 0; j++)
+      {
+         str[--i] = nn_digit_char(r % base, base);
+         r /= base;
       }
    }
 
-   str[digits - i] = '\0';
-
-   return str;
+   while (i > 0)
+      str[--i] = '0';
 }
 
 #endif
 
-#ifndef HAVE_ARCH_set_str
+#ifndef HAVE_ARCH_nn_set_str_base_classical
 
-size_t nn_set_str(nn_t a, len_t * len, const char * str)
+len_t nn_set_str_base_classical(nn_t a, const char * str, 
+                                          size_t digits, int base)
 {
-   len_t m = 1;
-   size_t i, digits = strspn(str, "0123456789");
-   word_t ci;
+   len_t m = 0;
+   size_t i, j, c = 1, n;
+   word_t ci, w, p, d = base;
 
-   if (digits == 1 && str[0] == '0')
+   while (d <= ((word_t) -1)/base)
    {
-      *len = 0;
-      return 1;
+      d *= base;
+      c++;
    }
 
-   a[0] = (word_t) str[0] - 48;
-   for (i = 1; i < digits; i++) 
+   /* consume c digits at a time, the first chunk short */
+   for (i = 0; i < digits; i += n)
    {
-      ci = nn_mul1(a, a, m, 10);
-      ci += nn_add1(a, a, m, (word_t) str[i] - 48);
+      n = (i == 0 && digits % c) ? digits % c : c;
+      
+      for (j = 0, w = 0, p = 1; j < n; j++, p *= base)
+         w = base*w + (word_t) nn_digit_value(str[i + j], base);
+
+      ci = nn_mul1(a, a, m, p);
+      ci += nn_add1(a, a, m, w);
       if (ci) a[m++] = ci;
    }
 
-   *len = m;
-   return digits;
+   return m;
 }
 
 #endif
@@ -810,11 +963,7 @@ size_t nn_set_str(nn_t a, len_t * len, const char * str)
 
 void nn_print(nn_src_t a, len_t m)
 {
-   char * str = nn_get_str(a, m);
-
-   printf("%s", str);
-
-   free(str);
+   nn_out_str(stdout, a, m);
 }
 
 #endif
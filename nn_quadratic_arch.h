@@ -0,0 +1,3 @@
+#ifndef nn_quadratic_H
+#define nn_quadratic_H
+#endif
@@ -60,7 +60,11 @@ void nn_mul_kara(nn_t p, nn_src_t a, len_t m, nn_src_t b, len_t n)
    ci = -nn_sub(t, t, 2*m2 + 1, p, 2*m2);
    t[2*m2 + 1] = ci - nn_sub(t, t, 2*m2 + 1, p + 2*m2, h1 + h2);
    
-   nn_add(p + m2, p + m2, m + h2, t, 2*m2 + 1);
+   /* 
+      the middle term is at most ab/B^m2 so fits in m + h2 words, which 
+      is only 2*m2 if m is odd and h2 = 1
+   */
+   nn_add(p + m2, p + m2, m + h2, t, BSDNT_MIN(2*m2 + 1, m + h2));
    
    TMP_END;
 }
@@ -644,3 +648,244 @@ void nn_div_divconquer_preinv_c(nn_t q, nn_t a, len_t m, nn_src_t d,
 }
 
 #endif
+
+void _nn_get_str_divconquer(char * str, size_t digits, nn_t a, len_t m,
+                            nn_t * pow, len_t * plen, len_t k)
+{
+   size_t lo;
+   len_t qn;
+   nn_t q;
+   TMP_INIT;
+
+   m = nn_normalise(a, m);
+
+   /* find a power of roughly half the size of a */
+   while (k >= 0 && (2*plen[k] > m + 1 
+                 || (size_t) DEC_WORD_DIGITS << k >= digits))
+      k--;
+
+   if (m < GET_STR_DIVCONQUER_CUTOFF || k < 0)
+   {
+      nn_get_str_classical(str, digits, a, m);
+      return;
+   }
+
+   TMP_START;
+
+   qn = m - plen[k] + 1;
+   q = (nn_t) TMP_ALLOC(qn);
+
+   nn_divrem(q, a, m, pow[k], plen[k]);
+
+   lo = (size_t) DEC_WORD_DIGITS << k;
+   
+   _nn_get_str_divconquer(str, digits - lo, q, qn, pow, plen, k);
+   _nn_get_str_divconquer(str + digits - lo, lo, a, plen[k], pow, plen, k - 1);
+
+   TMP_END;
+}
+
+len_t _nn_dec_powers(nn_t * pow, len_t * plen, nn_t t, len_t m)
+{
+   len_t k;
+
+   pow[0] = t;
+   pow[0][0] = DEC_WORD_BASE;
+   plen[0] = 1;
+
+   for (k = 0; 4*plen[k] <= m + 1; k++)
+   {
+      pow[k + 1] = pow[k] + plen[k];
+      nn_mul(pow[k + 1], pow[k], plen[k], pow[k], plen[k]);
+      plen[k + 1] = nn_normalise(pow[k + 1], 2*plen[k]);
+   }
+
+   return k;
+}
+
+void nn_get_str_divconquer(char * str, size_t digits, nn_t a, len_t m)
+{
+   nn_t pow[WORD_BITS];
+   len_t plen[WORD_BITS];
+   len_t k;
+   TMP_INIT;
+
+   m = nn_normalise(a, m);
+
+   TMP_START;
+
+   k = _nn_dec_powers(pow, plen, (nn_t) TMP_ALLOC(2*m + 2), m);
+
+   _nn_get_str_divconquer(str, digits, a, m, pow, plen, k);
+
+   TMP_END;
+}
+
+/*
+   Write exactly the given number of decimal digits of {a, m} to the
+   stream f, given pow[i] = 10^(DEC_WORD_DIGITS*2^i) of plen[i] words
+   for 0 <= i <= k, and return the number of characters written. While
+   *lead is set, leading zeroes are skipped; it is cleared once the
+   first nonzero digit has been written.
+*/
+static
+size_t _nn_out_str_divconquer(FILE * f, size_t digits, nn_t a, len_t m,
+                         nn_t * pow, len_t * plen, len_t k, int * lead)
+{
+   size_t lo, n, i, w = 0;
+   len_t qn;
+   nn_t q;
+   char * str;
+   TMP_INIT;
+
+   m = nn_normalise(a, m);
+
+   while (k >= 0 && (2*plen[k] > m + 1 
+                 || (size_t) DEC_WORD_DIGITS << k >= digits))
+      k--;
+
+   TMP_START;
+
+   if (m < GET_STR_DIVCONQUER_CUTOFF || k < 0)
+   {
+      n = BSDNT_MIN(nn_sizeinbase(a, m, 10), digits);
+      
+      /* zero padding need not be formatted */
+      if (!*lead)
+      {
+         for (i = n; i < digits; i++)
+            putc('0', f);
+         w = digits - n;
+      }
+      
+      str = (char *) TMP_ALLOC_BYTES(n);
+      nn_get_str_classical(str, n, a, m);
+
+      for (i = 0; *lead && i < n - 1 && str[i] == '0'; i++) ;
+      
+      if (str[i] != '0')
+         *lead = 0;
+
+      if (!*lead)
+         w += fwrite(str + i, 1, n - i, f);
+   } else
+   {
+      qn = m - plen[k] + 1;
+      q = (nn_t) TMP_ALLOC(qn);
+
+      nn_divrem(q, a, m, pow[k], plen[k]);
+
+      lo = (size_t) DEC_WORD_DIGITS << k;
+   
+      w = _nn_out_str_divconquer(f, digits - lo, q, qn, pow, plen, k, lead);
+      w += _nn_out_str_divconquer(f, lo, a, plen[k], pow, plen, k - 1, lead);
+   }
+
+   TMP_END;
+
+   return w;
+}
+
+size_t nn_out_str_divconquer(FILE * f, nn_t a, len_t m)
+{
+   nn_t pow[WORD_BITS];
+   len_t plen[WORD_BITS];
+   len_t k;
+   size_t w;
+   int lead = 1;
+   TMP_INIT;
+
+   ASSERT(m > 0 && a[m - 1] != 0);
+
+   TMP_START;
+
+   k = _nn_dec_powers(pow, plen, (nn_t) TMP_ALLOC(2*m + 2), m);
+
+   w = _nn_out_str_divconquer(f, nn_sizeinbase(a, m, 10), 
+                                              a, m, pow, plen, k, &lead);
+
+   TMP_END;
+
+   return w;
+}
+
+/* 
+   Return an upper bound for the number of words required for a 
+   decimal number with the given number of digits. 3.32... is 
+   log_2(10).
+*/
+#define DEC_DIGITS_TO_WORDS(digits) \
+   ((len_t) ((digits)*3.321928094887362/WORD_BITS) + 2)
+
+/*
+   Set a to the value of the given number of decimal digits of str and 
+   return its length, given pow[i] = 10^(DEC_WORD_DIGITS*2^i) of plen[i]
+   words for 0 <= i <= k.
+*/
+static
+len_t _nn_set_str_divconquer(nn_t a, const char * str, size_t digits,
+                             nn_t * pow, len_t * plen, len_t k)
+{
+   size_t lo;
+   len_t hn, ln, n;
+   nn_t h, l, t;
+   TMP_INIT;
+
+   /* find a power of roughly half the size of the result */
+   while (k >= 0 && (size_t) DEC_WORD_DIGITS << (k + 1) > digits)
+      k--;
+
+   if (k < 0 || digits < (size_t) SET_STR_DIVCONQUER_CUTOFF*DEC_WORD_DIGITS)
+      return nn_set_str_classical(a, str, digits);
+
+   TMP_START;
+   
+   lo = (size_t) DEC_WORD_DIGITS << k;
+   
+   h = (nn_t) TMP_ALLOC(DEC_DIGITS_TO_WORDS(digits - lo));
+   l = (nn_t) TMP_ALLOC(plen[k]);
+   
+   hn = _nn_set_str_divconquer(h, str, digits - lo, pow, plen, k);
+   ln = _nn_set_str_divconquer(l, str + digits - lo, lo, pow, plen, k - 1);
+
+   if (hn == 0)
+   {
+      nn_copy(a, l, ln);
+      n = ln;
+   } else /* a = h*10^lo + l */
+   {
+      n = hn + plen[k];
+      t = (nn_t) TMP_ALLOC(n);
+
+      if (hn >= plen[k])
+         nn_mul(t, h, hn, pow[k], plen[k]);
+      else
+         nn_mul(t, pow[k], plen[k], h, hn);
+
+      nn_add(t, t, n, l, ln);
+      n = nn_normalise(t, n);
+      nn_copy(a, t, n);
+   }
+
+   TMP_END;
+
+   return n;
+}
+
+len_t nn_set_str_divconquer(nn_t a, const char * str, size_t digits)
+{
+   nn_t pow[WORD_BITS];
+   len_t plen[WORD_BITS];
+   len_t k, m = DEC_DIGITS_TO_WORDS(digits);
+   TMP_INIT;
+
+   TMP_START;
+
+   k = _nn_dec_powers(pow, plen, (nn_t) TMP_ALLOC(2*m + 2), m);
+
+   m = _nn_set_str_divconquer(a, str, digits, pow, plen, k);
+
+   TMP_END;
+
+   return m;
+}
@@ -0,0 +1,3 @@
+#ifndef nn_subquadratic_H
+#define nn_subquadratic_H
+#endif
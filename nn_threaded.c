@@ -0,0 +1,140 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pthread.h>
+#include "nn.h"
+
+/*
+   Arguments for a thread converting one subtree of the divide and 
+   conquer decimal conversion.
+*/
+typedef struct _nn_get_str_arg_t
+{
+   char * str;
+   size_t digits;
+   nn_t a;
+   len_t m;
+   nn_t * pow;
+   len_t * plen;
+   len_t k;
+   long threads;
+} _nn_get_str_arg_t;
+
+static
+void * _nn_get_str_threaded(void * arg);
+
+/*
+   As per _nn_get_str_divconquer, but the high and low halves at each 
+   level are converted concurrently while more than one thread is 
+   available. Each thread allocates its own scratch space, the powers 
+   are shared and only read.
+*/
+static
+void _nn_get_str_divconquer_threaded(char * str, size_t digits, nn_t a, 
+                  len_t m, nn_t * pow, len_t * plen, len_t k, long threads)
+{
+   _nn_get_str_arg_t hi;
+   pthread_t thread;
+   size_t lo;
+   len_t qn;
+   nn_t q;
+   TMP_INIT;
+
+   m = nn_normalise(a, m);
+
+   while (k >= 0 && (2*plen[k] > m + 1 
+                 || (size_t) DEC_WORD_DIGITS << k >= digits))
+      k--;
+
+   if (threads <= 1 || m < GET_STR_DIVCONQUER_CUTOFF || k < 0)
+   {
+      _nn_get_str_divconquer(str, digits, a, m, pow, plen, k);
+      return;
+   }
+
+   TMP_START;
+
+   qn = m - plen[k] + 1;
+   q = (nn_t) TMP_ALLOC(qn);
+
+   nn_divrem(q, a, m, pow[k], plen[k]);
+
+   lo = (size_t) DEC_WORD_DIGITS << k;
+   
+   hi.str = str;
+   hi.digits = digits - lo;
+   hi.a = q;
+   hi.m = qn;
+   hi.pow = pow;
+   hi.plen = plen;
+   hi.k = k;
+   hi.threads = threads/2;
+
+   if (pthread_create(&thread, NULL, _nn_get_str_threaded, &hi) != 0)
+   {
+      _nn_get_str_threaded(&hi); /* no thread available, convert here */
+      _nn_get_str_divconquer_threaded(str + digits - lo, lo, a, plen[k], 
+                                      pow, plen, k - 1, threads - threads/2);
+   } else
+   {
+      _nn_get_str_divconquer_threaded(str + digits - lo, lo, a, plen[k], 
+                                      pow, plen, k - 1, threads - threads/2);
+      pthread_join(thread, NULL);
+   }
+
+   TMP_END;
+}
+
+static
+void * _nn_get_str_threaded(void * arg)
+{
+   _nn_get_str_arg_t * t = (_nn_get_str_arg_t *) arg;
+
+   _nn_get_str_divconquer_threaded(t->str, t->digits, t->a, t->m, 
+                                             t->pow, t->plen, t->k, t->threads);
+
+   return NULL;
+}
+
+void nn_get_str_divconquer_threaded(char * str, size_t digits, 
+                                           nn_t a, len_t m, long threads)
+{
+   nn_t pow[WORD_BITS];
+   len_t plen[WORD_BITS];
+   len_t k;
+   TMP_INIT;
+
+   m = nn_normalise(a, m);
+
+   TMP_START;
+
+   k = _nn_dec_powers(pow, plen, (nn_t) TMP_ALLOC(2*m + 2), m);
+
+   _nn_get_str_divconquer_threaded(str, digits, a, m, pow, plen, k, threads);
+
+   TMP_END;
+}
@@ -0,0 +1,3 @@
+#ifndef nn_threaded_H
+#define nn_threaded_H
+#endif
@@ -0,0 +1,123 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "nn.h"
+#include "test.h"
+
+#undef ITER
+#define ITER 200000
+
+rand_t state;
+
+len_t fixed_len[] = { 2, 3, 4, 6, 8, 12, 16, 24, 32 };
+
+/*
+   Time the generic and fixed length multiplication, squaring and 
+   Montgomery multiplication at each kernel length and print the time
+   per call of each, in nanoseconds.
+*/
+void time_fixed(void)
+{
+   nn_t a, b, d, q, t, r;
+   hensel_preinv1_t dinv;
+   double t1, t2;
+   clock_t c;
+   long count;
+   len_t i, n;
+
+   for (i = 0; i < (len_t) (sizeof(fixed_len)/sizeof(len_t)); i++)
+   {
+      n = fixed_len[i];
+      
+      randoms_of_len(n, FULL, state, &a, &b, &d, &r, NULL);
+      randoms_of_len(2*n, ANY, state, &t, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      d[0] |= 1;
+      nn_divrem(q, a, n, d, n);
+      nn_divrem(q, b, n, d, n);
+      precompute_hensel_inverse1(&dinv, d[0]);
+
+      printf("n = %ld:", n);
+
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         nn_mul_classical(t, a, n, b, n);
+      t1 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+      
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         nn_mul_fixed(t, a, b, n);
+      t2 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+
+      printf(" mul %.1f/%.1f", 1e9*t1, 1e9*t2);
+
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         nn_sqr_classical(t, a, n);
+      t1 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+      
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         nn_sqr_fixed(t, a, n);
+      t2 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+
+      printf(", sqr %.1f/%.1f", 1e9*t1, 1e9*t2);
+
+      c = clock();
+      for (count = 0; count < ITER; count++)
+      {
+         nn_mul_classical(t, a, n, b, n);
+         nn_redc_classical(r, t, d, n, dinv);
+      }
+      t1 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+      
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         nn_mont_mul_fixed(r, a, b, d, n, dinv);
+      t2 = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+
+      printf(", mont_mul %.1f/%.1f ns\n", 1e9*t1, 1e9*t2);
+
+      gc_cleanup();
+   }
+}
+
+int main(void)
+{
+   printf("\nTiming generic/fixed length kernels:\n");
+   
+   randinit(&state);
+   
+   time_fixed();
+
+   randclear(state);
+
+   return 0;
+}
@@ -0,0 +1,131 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "nn.h"
+#include "test.h"
+
+#undef ITER
+#define ITER 200
+
+#define CLASSES 3
+
+rand_t state;
+
+/*
+   Set e to an exponent of en words with few, many or random bits set,
+   depending on the class c. The top bit is always set.
+*/
+void exponent(nn_t e, len_t en, int c)
+{
+   len_t i;
+
+   for (i = 0; i < en; i++)
+   {
+      if (c == 0)
+         e[i] = 0;
+      else if (c == 1)
+         e[i] = ~WORD(0);
+      else
+         e[i] = randword(state);
+   }
+
+   e[en - 1] |= (WORD(1) << (WORD_BITS - 1));
+}
+
+/*
+   Time ITER calls of the given powering function for exponents of 
+   each class, and print the mean time per call for each class and the
+   spread (max - min)/mean over the classes.
+*/
+void time_class(const char * name, 
+                void (*powm)(nn_t, nn_src_t, len_t, nn_src_t, len_t, 
+                                                    nn_src_t, len_t), 
+                nn_src_t a, nn_src_t d, len_t n, nn_t e, nn_t r)
+{
+   double t[CLASSES], min, max, mean = 0;
+   clock_t c;
+   long count;
+   int j;
+
+   for (j = 0; j < CLASSES; j++)
+   {
+      exponent(e, n, j);
+
+      c = clock();
+      for (count = 0; count < ITER; count++)
+         powm(r, a, n, e, n, d, n);
+      t[j] = ((double) (clock() - c))/CLOCKS_PER_SEC/ITER;
+   }
+
+   min = max = t[0];
+   for (j = 0; j < CLASSES; j++)
+   {
+      mean += t[j]/CLASSES;
+      min = BSDNT_MIN(min, t[j]);
+      max = BSDNT_MAX(max, t[j]);
+   }
+
+   printf("%s: sparse = %.3gs, dense = %.3gs, random = %.3gs, "
+          "spread = %.1f%%\n", name, t[0], t[1], t[2], 100*(max - min)/mean);
+}
+
+void time_powm_sec(void)
+{
+   nn_t a, d, e, r;
+   len_t n;
+
+   for (n = 4; n <= 32; n *= 2)
+   {
+      randoms_of_len(n, ANY, state, &a, &d, &e, &r, NULL);
+      d[0] |= 1;
+      d[n - 1] |= (WORD(1) << (WORD_BITS - 1));
+
+      printf("n = %ld:\n", n);
+
+      time_class("   powm    ", nn_powm, a, d, n, e, r);
+      time_class("   powm_sec", nn_powm_sec, a, d, n, e, r);
+
+      gc_cleanup();
+   }
+}
+
+int main(void)
+{
+   printf("\nTiming variance of nn_powm_sec vs nn_powm over exponents:\n");
+   
+   randinit(&state);
+   
+   time_powm_sec();
+
+   randclear(state);
+
+   return 0;
+}
@@ -0,0 +1,85 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "nn.h"
+#include "test.h"
+
+rand_t state;
+
+/*
+   Time nn_sqrtrem of a 2n word value against nn_mul_m of two n word
+   values, and print the ratio.
+*/
+void time_sqrtrem(void)
+{
+   nn_t a, b, s, r, p;
+   len_t n;
+   long count, iter;
+   clock_t t;
+   double t1, t2;
+
+   for (n = 1; n <= 20000; n = (long) ceil(n*1.5))
+   {
+      randoms_of_len(2*n, FULL, state, &a, &p, NULL);
+      randoms_of_len(n, FULL, state, &b, NULL);
+      randoms_of_len(n + 1, ANY, state, &s, &r, NULL);
+      
+      iter = BSDNT_MAX(2, 10000000/(n*n + 100));
+
+      t = clock();
+      for (count = 0; count < iter; count++)
+         nn_mul_m(p, a, b, n);
+      t1 = ((double) (clock() - t))/CLOCKS_PER_SEC/iter;
+
+      t = clock();
+      for (count = 0; count < iter; count++)
+         nn_sqrtrem(s, r, a, 2*n);
+      t2 = ((double) (clock() - t))/CLOCKS_PER_SEC/iter;
+
+      printf("n = %ld: mul_m = %gs, sqrtrem = %gs, ratio = %.2f\n", 
+                                                   n, t1, t2, t2/t1);
+     
+      gc_cleanup();
+   }
+}
+
+int main(void)
+{
+   printf("\nTiming nn_sqrtrem vs nn_mul_m:\n");
+   
+   randinit(&state);
+   
+   time_sqrtrem();
+
+   randclear(state);
+
+   return 0;
+}
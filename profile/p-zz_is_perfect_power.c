@@ -0,0 +1,102 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "nn.h"
+#include "zz.h"
+#include "test.h"
+
+rand_t state;
+
+/*
+   Time zz_is_perfect_power and zz_is_square of a random odd n word 
+   value against zz_sqrtrem, and print the ratios. A random value is
+   rejected by residues alone. The residues for all exponents with 
+   large roots come from a single remainder tree over the value, so 
+   the ratio for zz_is_perfect_power should stay bounded as n grows, 
+   rather than growing linearly as it would with a pass per exponent.
+*/
+void time_is_perfect_power(void)
+{
+   zz_t a, s, r;
+   len_t n;
+   long count, iter;
+   clock_t t;
+   double t1, t2, t3;
+
+   zz_init(a);
+   zz_init(s);
+   zz_init(r);
+
+   for (n = 1; n <= 20000; n = (long) ceil(n*1.5))
+   {
+      do zz_random(a, state, n); while (BSDNT_ABS(a->size) != n);
+      if (a->size < 0)
+         zz_neg(a, a);
+      a->n[0] |= 1;
+      
+      iter = BSDNT_MAX(2, 10000000/(n*n + 100));
+
+      t = clock();
+      for (count = 0; count < iter; count++)
+         zz_sqrtrem(s, r, a);
+      t1 = ((double) (clock() - t))/CLOCKS_PER_SEC/iter;
+
+      t = clock();
+      for (count = 0; count < iter; count++)
+         zz_is_perfect_power(NULL, a);
+      t2 = ((double) (clock() - t))/CLOCKS_PER_SEC/iter;
+
+      t = clock();
+      for (count = 0; count < iter; count++)
+         zz_is_square(a);
+      t3 = ((double) (clock() - t))/CLOCKS_PER_SEC/iter;
+
+      printf("n = %ld: sqrtrem = %gs, is_perfect_power = %gs (%.3f), "
+             "is_square = %gs (%.3f)\n", n, t1, t2, t2/t1, t3, t3/t1);
+   }
+
+   zz_clear(a);
+   zz_clear(s);
+   zz_clear(r);
+}
+
+int main(void)
+{
+   printf("\nTiming zz_is_perfect_power and zz_is_square vs zz_sqrtrem:\n");
+   
+   randinit(&state);
+   
+   time_is_perfect_power();
+
+   randclear(state);
+
+   return 0;
+}
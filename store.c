@@ -0,0 +1,296 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#if defined(__MINGW32__)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "store.h"
+
+#define STORE_ORDER ((uint64_t) 0x0102030405060708ULL)
+
+/*
+   Round n up to a multiple of the power of 2 given by align.
+*/
+static inline
+uint64_t _store_round(uint64_t n, uint64_t align)
+{
+   return (n + align - 1) & ~(align - 1);
+}
+
+/*
+   Return the offset, on or after off, at which limbs of the given 
+   number of bytes are stored.
+*/
+static inline
+uint64_t _store_place(uint64_t off, uint64_t bytes)
+{
+   return _store_round(off, bytes >= STORE_ALIGN ? STORE_ALIGN : sizeof(word_t));
+}
+
+/*
+   Write n zero bytes to f and return 0, or return -1 on failure.
+*/
+static
+int _store_pad(FILE * f, uint64_t n)
+{
+   static const char zero[STORE_ALIGN] = { 0 };
+
+   return fwrite(zero, 1, (size_t) n, f) == n ? 0 : -1;
+}
+
+int store_write(const char * path, const zz_struct * a, size_t count)
+{
+   store_header_t hdr;
+   store_index_t e;
+   uint64_t off, bytes;
+   size_t i;
+   int ret = 0;
+   FILE * f = fopen(path, "wb");
+
+   if (f == NULL)
+      return -1;
+
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.magic, STORE_MAGIC, sizeof(hdr.magic));
+   hdr.version = STORE_VERSION;
+   hdr.word_bytes = sizeof(word_t);
+   hdr.order = STORE_ORDER;
+   hdr.count = count;
+   hdr.index = _store_round(STORE_HEADER_BYTES, STORE_ALIGN);
+   hdr.data = _store_round(hdr.index + count*sizeof(store_index_t), STORE_ALIGN);
+   
+   /* first pass computes the total size */
+   for (i = 0, off = hdr.data; i < count; i++)
+   {
+      bytes = BSDNT_ABS(a[i].size)*sizeof(word_t);
+      off = _store_place(off, bytes) + bytes;
+   }
+   hdr.bytes = off;
+
+   if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 
+    || _store_pad(f, hdr.index - sizeof(hdr)) != 0)
+      ret = -1;
+
+   for (i = 0, off = hdr.data; i < count && ret == 0; i++)
+   {
+      bytes = BSDNT_ABS(a[i].size)*sizeof(word_t);
+      e.offset = _store_place(off, bytes);
+      e.size = a[i].size;
+      off = e.offset + bytes;
+
+      if (fwrite(&e, sizeof(e), 1, f) != 1)
+         ret = -1;
+   }
+
+   if (ret == 0)
+      ret = _store_pad(f, hdr.data - hdr.index - count*sizeof(store_index_t));
+
+   for (i = 0, off = hdr.data; i < count && ret == 0; i++)
+   {
+      bytes = BSDNT_ABS(a[i].size)*sizeof(word_t);
+      
+      /* a zero entry need not have any limbs allocated */
+      if (_store_pad(f, _store_place(off, bytes) - off) != 0
+       || (bytes != 0 && fwrite(a[i].n, 1, (size_t) bytes, f) != bytes))
+         ret = -1;
+
+      off = _store_place(off, bytes) + bytes;
+   }
+
+   if (fclose(f) != 0)
+      ret = -1;
+
+   return ret;
+}
+
+/*
+   Return 1 if the mapped file described by S->map and S->bytes is a 
+   valid table for this machine, and if so set S->count and S->index.
+   Otherwise return 0.
+*/
+static
+int _store_check(store_t S)
+{
+   const store_header_t * hdr = (const store_header_t *) S->map;
+   const store_index_t * e;
+   uint64_t limbs, bytes;
+   size_t i;
+
+   if (memcmp(hdr->magic, STORE_MAGIC, sizeof(hdr->magic)) != 0
+    || hdr->version != STORE_VERSION || hdr->word_bytes != sizeof(word_t)
+    || hdr->order != STORE_ORDER || hdr->bytes != S->bytes
+    || hdr->index < STORE_HEADER_BYTES || hdr->index % STORE_ALIGN != 0
+    || hdr->index > S->bytes
+    || hdr->count > (S->bytes - hdr->index)/sizeof(store_index_t))
+      return 0;
+
+   S->count = (size_t) hdr->count;
+   S->index = (const store_index_t *) (S->map + hdr->index);
+
+   /* check every entry lies within the file and is normalised */
+   for (i = 0; i < S->count; i++)
+   {
+      e = S->index + i;
+
+      /* e->size may be INT64_MIN, so negate it unsigned */
+      limbs = e->size < 0 ? 0 - (uint64_t) e->size : (uint64_t) e->size;
+      bytes = limbs*sizeof(word_t);
+      
+      if (e->offset % sizeof(word_t) != 0 || e->offset > S->bytes 
+       || limbs > (S->bytes - e->offset)/sizeof(word_t)
+       || (bytes != 0 && ((const word_t *) (S->map + e->offset + bytes))[-1] == 0))
+         return 0;
+   }
+
+   return 1;
+}
+
+#if defined(__MINGW32__)
+
+/*
+   Map the file with the given path read only into memory, setting 
+   *bytes to its length. Returns NULL on failure.
+*/
+static
+const unsigned char * _store_map(const char * path, size_t * bytes)
+{
+   LARGE_INTEGER size;
+   HANDLE h, fh;
+   void * map = NULL;
+
+   fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, 
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (fh == INVALID_HANDLE_VALUE)
+      return NULL;
+
+   if (GetFileSizeEx(fh, &size) && (uint64_t) size.QuadPart >= STORE_HEADER_BYTES
+    && (uint64_t) size.QuadPart <= (size_t) -1)
+   {
+      h = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+      
+      if (h != NULL)
+      {
+         map = MapViewOfFile(h, FILE_MAP_READ, 0, 0, 0);
+         CloseHandle(h); /* the view remains valid */
+         *bytes = (size_t) size.QuadPart;
+      }
+   }
+   
+   CloseHandle(fh);
+
+   return (const unsigned char *) map;
+}
+
+static
+void _store_unmap(const unsigned char * map, size_t bytes)
+{
+   UnmapViewOfFile((void *) map);
+}
+
+#else
+
+/*
+   Map the file with the given path read only into memory, setting 
+   *bytes to its length. Returns NULL on failure.
+*/
+static
+const unsigned char * _store_map(const char * path, size_t * bytes)
+{
+   struct stat st;
+   void * map;
+   int fd = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return NULL;
+
+   if (fstat(fd, &st) != 0 || (size_t) st.st_size < STORE_HEADER_BYTES)
+   {
+      close(fd);
+      return NULL;
+   }
+
+   map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd); /* the mapping remains valid */
+
+   if (map == MAP_FAILED)
+      return NULL;
+
+   *bytes = (size_t) st.st_size;
+
+   return (const unsigned char *) map;
+}
+
+static
+void _store_unmap(const unsigned char * map, size_t bytes)
+{
+   munmap((void *) map, bytes);
+}
+
+#endif
+
+int store_open(store_t S, const char * path)
+{
+   S->map = _store_map(path, &S->bytes);
+
+   if (S->map == NULL)
+      return -1;
+
+   if (!_store_check(S))
+   {
+      store_close(S);
+      return -1;
+   }
+
+   return 0;
+}
+
+void store_close(store_t S)
+{
+   _store_unmap(S->map, S->bytes);
+   
+   S->map = NULL;
+   S->bytes = 0;
+   S->count = 0;
+   S->index = NULL;
+}
+
+void store_get_zz(zz_ptr r, const store_t S, size_t i)
+{
+   len_t m;
+   nn_src_t a = store_entry(S, i, &m);
+
+   zz_fit(r, m);
+   nn_copy(r->n, a, m);
+   r->size = store_sign(S, i) < 0 ? -m : m;
+}
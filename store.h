@@ -0,0 +1,156 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BSDNT_STORE_H
+#define BSDNT_STORE_H
+
+#include <stdint.h>
+#include "helper.h"
+#include "nn.h"
+#include "zz.h"
+
+/**********************************************************************
+ 
+    On disk tables of integers
+
+**********************************************************************/
+
+/*
+   A table of integers is stored in a single file, laid out as follows. 
+   All fields are in the native byte order of the machine that wrote 
+   the file, and a reader rejects files with a different word size or
+   byte order.
+
+      header   STORE_HEADER_BYTES bytes, see store_header_t
+      index    count entries of type store_index_t
+      data     the limbs of each entry, least significant first
+
+   The index and data both start on a STORE_ALIGN byte boundary and the
+   limbs of each entry start on a word boundary, so that once the file
+   is mapped into memory each entry can be used directly as an 
+   nn_src_t. The limbs of an entry of STORE_ALIGN bytes or more start 
+   on a STORE_ALIGN byte boundary.
+*/
+
+#define STORE_MAGIC "bsdnttab"
+
+#define STORE_VERSION 1
+
+#define STORE_ALIGN 64
+
+#define STORE_HEADER_BYTES 64
+
+typedef struct store_header_t
+{
+   char magic[8];      /* STORE_MAGIC, without the terminating null */
+   uint32_t version;   /* STORE_VERSION */
+   uint32_t word_bytes; /* sizeof(word_t) */
+   uint64_t order;     /* 0x0102030405060708 in the writer's byte order */
+   uint64_t count;     /* number of entries */
+   uint64_t index;     /* offset of the index in bytes */
+   uint64_t data;      /* offset of the data in bytes */
+   uint64_t bytes;     /* total file size in bytes */
+} store_header_t;
+
+typedef struct store_index_t
+{
+   uint64_t offset;    /* offset of the limbs in bytes from the file start */
+   int64_t size;       /* number of limbs, negative for negative values */
+} store_index_t;
+
+typedef struct store_struct
+{
+   const unsigned char * map; /* the mapped file */
+   size_t bytes;       /* length of the mapping */
+   size_t count;       /* number of entries */
+   const store_index_t * index;
+} store_struct;
+
+typedef store_struct store_t[1];
+
+/*
+   Write the count integers a[0], ..., a[count - 1] to a table in the
+   file with the given path, replacing any existing file. Returns 0 on
+   success, or -1 if the file could not be written.
+*/
+int store_write(const char * path, const zz_struct * a, size_t count);
+
+/*
+   Map the table in the file with the given path read only into memory
+   and set S to describe it. Returns 0 on success, or -1 if the file 
+   could not be mapped or is not a valid table for this machine. No
+   limbs are read or copied until an entry is used.
+*/
+int store_open(store_t S, const char * path);
+
+/*
+   Unmap the table S. Any pointers obtained from it become invalid.
+*/
+void store_close(store_t S);
+
+/*
+   Return the number of entries in the table S.
+*/
+static inline
+size_t store_count(const store_t S)
+{
+   return S->count;
+}
+
+/*
+   Return the limbs of entry i of the table S, setting *m to the number 
+   of limbs. The result points into the mapped file, is normalised and 
+   may be passed directly to any nn function accepting an nn_src_t.
+*/
+static inline
+nn_src_t store_entry(const store_t S, size_t i, len_t * m)
+{
+   ASSERT(i < S->count);
+
+   *m = (len_t) BSDNT_ABS(S->index[i].size);
+
+   return (nn_src_t) (S->map + S->index[i].offset);
+}
+
+/*
+   Return -1 if entry i of the table S is negative, 1 if it is positive
+   and 0 if it is zero.
+*/
+static inline
+int store_sign(const store_t S, size_t i)
+{
+   ASSERT(i < S->count);
+
+   return (S->index[i].size > 0) - (S->index[i].size < 0);
+}
+
+/*
+   Set r to a copy of entry i of the table S.
+*/
+void store_get_zz(zz_ptr r, const store_t S, size_t i);
+
+#endif
@@ -0,0 +1,358 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nn.h"
+#include "nmod.h"
+#include "test.h"
+
+#undef ITER
+#define ITER 50000
+
+rand_t state;
+
+/* return a random modulus, often of a special form */
+word_t random_modulus(rand_t state)
+{
+   word_t n;
+
+   switch (randint(4, state))
+   {
+   case 0: /* small */
+      n = randint(1000, state) + 1;
+      break;
+   case 1: /* less than B/2 */
+      n = randword(state) >> (randint(WORD_BITS - 1, state) + 1);
+      break;
+   case 2: /* normalised */
+      n = randword(state) | (WORD(1) << (WORD_BITS - 1));
+      break;
+   default:
+      n = randword(state);
+   }
+
+   return n == 0 ? 1 : n;
+}
+
+word_t n_mulmod_naive(word_t a, word_t b, word_t n)
+{
+   return (word_t) (((dword_t) a * (dword_t) b) % (dword_t) n);
+}
+
+int test_mulmod_preinv(void)
+{
+   int result = 1;
+   word_t n, a, b, r1, r2;
+   nmod_t mod;
+
+   printf("n_mulmod_preinv...");
+
+   TEST_START(1, ITER) /* test against dword arithmetic */
+   {
+      n = random_modulus(state);
+      a = randword(state) % n;
+      b = randword(state) % n;
+      
+      nmod_init(&mod, n);
+
+      r1 = n_mulmod_preinv(a, b, mod);
+      r2 = n_mulmod_naive(a, b, n);
+
+      result = (r1 == r2);
+
+      if (!result) 
+         printf("n = %lx, a = %lx, b = %lx, r1 = %lx, r2 = %lx\n", 
+                                                      n, a, b, r1, r2);
+   } TEST_END;
+
+   return result;
+}
+
+int test_addmod_submod(void)
+{
+   int result = 1;
+   word_t n, a, b, r1, r2;
+   nmod_t mod;
+
+   printf("n_addmod/submod...");
+
+   TEST_START(1, ITER) /* test against dword arithmetic */
+   {
+      n = random_modulus(state);
+      a = randword(state) % n;
+      b = randword(state) % n;
+      
+      nmod_init(&mod, n);
+
+      r1 = n_addmod(a, b, mod);
+      r2 = (word_t) (((dword_t) a + (dword_t) b) % (dword_t) n);
+
+      result = (r1 == r2);
+
+      r1 = n_submod(a, b, mod);
+      r2 = (word_t) (((dword_t) a + (dword_t) (n - b)) % (dword_t) n);
+
+      result &= (r1 == r2);
+
+      if (!result) 
+         printf("n = %lx, a = %lx, b = %lx\n", n, a, b);
+   } TEST_END;
+
+   return result;
+}
+
+int test_powmod(void)
+{
+   int result = 1;
+   word_t n, a, e1, e2, r1, r2;
+   nmod_t mod;
+
+   printf("n_powmod...");
+
+   TEST_START(1, ITER) /* test a^(e1 + e2) = a^e1*a^e2 */
+   {
+      n = random_modulus(state);
+      a = randword(state) % n;
+      e1 = randword(state) >> 1;
+      e2 = randint(100, state);
+      
+      nmod_init(&mod, n);
+
+      r1 = n_powmod(a, e1 + e2, mod);
+      r2 = n_mulmod_preinv(n_powmod(a, e1, mod), n_powmod(a, e2, mod), mod);
+
+      result = (r1 == r2);
+
+      if (!result) 
+         printf("n = %lx, a = %lx, e1 = %lx, e2 = %lx\n", n, a, e1, e2);
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test a^(e + 1) = a^e*a */
+   {
+      n = random_modulus(state);
+      a = randword(state) % n;
+      e1 = randint(100, state);
+      
+      nmod_init(&mod, n);
+
+      r1 = n_powmod(a, e1 + 1, mod);
+      r2 = n_mulmod_naive(n_powmod(a, e1, mod), a, n);
+
+      result = (r1 == r2);
+
+      if (!result) 
+         printf("n = %lx, a = %lx, e = %lx\n", n, a, e1);
+   } TEST_END;
+
+   return result;
+}
+
+int test_invmod(void)
+{
+   int result = 1;
+   word_t n, a, g, r, t;
+   nmod_t mod;
+
+   printf("n_invmod...");
+
+   TEST_START(1, ITER) /* test a*r = 1 mod n, or gcd(a, n) != 1 */
+   {
+      n = random_modulus(state);
+      a = randword(state) % n;
+      
+      nmod_init(&mod, n);
+
+      r = n_invmod(a, mod);
+
+      if (r != 0)
+         result = (r < n && n_mulmod_naive(a, r, n) == 1);
+      else
+      {
+         for (g = n, t = a; t != 0; ) /* g = gcd(a, n) */
+         {
+            word_t u = g % t;
+            g = t;
+            t = u;
+         }
+
+         result = (n == 1 || g != 1);
+      }
+
+      if (!result) 
+         printf("n = %lx, a = %lx, r = %lx\n", n, a, r);
+   } TEST_END;
+
+   return result;
+}
+
+int test_mulmod_shoup(void)
+{
+   int result = 1;
+   word_t n, a, b, bpre, r1, r2;
+   nmod_t mod;
+
+   printf("n_mulmod_shoup...");
+
+   TEST_START(1, ITER) /* test against dword arithmetic */
+   {
+      do n = random_modulus(state); while (n >> (WORD_BITS - 1));
+      a = randword(state);
+      b = randword(state) % n;
+      
+      nmod_init(&mod, n);
+
+      bpre = n_mulmod_shoup_precomp(b, mod);
+      r1 = n_mulmod_shoup(a, b, bpre, mod);
+      r2 = n_mulmod_naive(a, b, n);
+
+      result = (r1 == r2);
+
+      if (!result) 
+         printf("n = %lx, a = %lx, b = %lx, r1 = %lx, r2 = %lx\n", 
+                                                      n, a, b, r1, r2);
+   } TEST_END;
+
+   return result;
+}
+
+void random_vec(nn_t a, len_t len, word_t n, rand_t state)
+{
+   len_t i;
+
+   for (i = 0; i < len; i++)
+      a[i] = randword(state) % n;
+}
+
+int test_vec(void)
+{
+   int result = 1;
+   word_t n, c, d1, d2;
+   len_t len, i;
+   nn_t a, b, r;
+   nmod_t mod;
+
+   printf("nmod_vec...");
+
+   TEST_START(1, ITER/10) /* test against the scalar functions */
+   {
+      randoms_upto(100, ANY, state, &len, NULL);
+      randoms_of_len(len, ANY, state, &a, &b, &r, NULL);
+
+      n = random_modulus(state);
+      c = randword(state) % n;
+
+      nmod_init(&mod, n);
+      
+      random_vec(a, len, n, state);
+      random_vec(b, len, n, state);
+
+      nmod_vec_add(r, a, b, len, mod);
+      for (i = 0; i < len && result; i++)
+         result = (r[i] == n_addmod(a[i], b[i], mod));
+
+      nmod_vec_sub(r, a, b, len, mod);
+      for (i = 0; i < len && result; i++)
+         result = (r[i] == n_submod(a[i], b[i], mod));
+
+      nmod_vec_neg(r, a, len, mod);
+      for (i = 0; i < len && result; i++)
+         result = (r[i] == n_negmod(a[i], mod));
+
+      nmod_vec_scalar_mul(r, a, len, c, mod);
+      for (i = 0; i < len && result; i++)
+         result = (r[i] == n_mulmod_naive(a[i], c, n));
+
+      d1 = nmod_vec_dot(a, b, len, mod);
+      for (i = 0, d2 = 0; i < len; i++)
+         d2 = n_addmod(d2, n_mulmod_naive(a[i], b[i], n), mod);
+      
+      result &= (d1 == d2);
+
+      if (!result) 
+      {
+         printf("n = %lx, c = %lx, len = %ld\n", n, c, len);
+         print_debug(a, len); print_debug(b, len);
+      }
+   } TEST_END;
+
+   TEST_START(aliasing, ITER/10) 
+   {
+      randoms_upto(100, ANY, state, &len, NULL);
+      randoms_of_len(len, ANY, state, &a, &b, &r, NULL);
+
+      n = random_modulus(state);
+      
+      nmod_init(&mod, n);
+      
+      random_vec(a, len, n, state);
+      random_vec(b, len, n, state);
+
+      nmod_vec_sub(r, a, b, len, mod);
+      nmod_vec_sub(a, a, b, len, mod);
+
+      result = nn_equal_m(r, a, len);
+
+      if (!result) 
+         printf("n = %lx, len = %ld\n", n, len);
+   } TEST_END;
+
+   return result;
+}
+
+int test(void)
+{
+   long pass = 0;
+   long fail = 0;
+   
+   RUN(test_mulmod_preinv);
+   RUN(test_addmod_submod);
+   RUN(test_powmod);
+   RUN(test_invmod);
+   RUN(test_mulmod_shoup);
+   RUN(test_vec);
+   
+   printf("%ld of %ld tests pass.\n", pass, pass + fail);
+
+   return (fail != 0);
+}
+
+int main(void)
+{
+   int ret = 0;
+   
+   printf("\nTesting nmod functions:\n");
+   
+   randinit(&state);
+   checkpoint_rand("First Random Word: ");
+
+   ret = test();
+
+   randclear(state);
+
+   return ret;
+}
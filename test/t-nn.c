@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "nn.h"
 #include "test.h"
 
@@ -245,6 +246,696 @@ int test_div(void)
    return result;
 }
 
+int test_invert_hensel(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, r, p;
+
+   printf("invert_hensel...");
+
+   TEST_START(1, ITER) /* test a*r = 1 mod B^m */
+   {
+      randoms_upto(200, NONZERO, state, &m, NULL);
+      
+      randoms_of_len(m, ODD, state, &a, NULL);
+      randoms_of_len(m, ANY, state, &r, NULL);
+      randoms_of_len(m + 2, ANY, state, &p, NULL);
+      
+      nn_invert_hensel(r, a, m);
+      nn_mullow(p + m, p, a, m, r, m);
+      
+      result = (p[0] == 1 && nn_normalise(p + 1, m - 1) == 0);
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(r, m);
+         print_debug(p, m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_invmod(void)
+{
+   int result = 1;
+   len_t m, n, s;
+   nn_t a, d, r, p, q, g, t1, t2;
+   bits_t bits;
+   int ret;
+
+   printf("invmod...");
+
+   TEST_START(1, ITER) /* test a*r = 1 mod d, or gcd(a, d) != 1 */
+   {
+      randoms_upto(40, NONZERO, state, &n, NULL);
+      randoms_upto(n + 1, ANY, state, &m, NULL);
+      randoms_upto(WORD_BITS, ANY, state, &bits, NULL);
+      
+      randoms_of_len(n, FULL, state, &d, NULL);
+      randoms_of_len(n, ANY, state, &a, &r, &g, &t1, &t2, NULL);
+      randoms_of_len(2*n, ANY, state, &p, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      switch (randint(4, state))
+      {
+      case 0: /* power of 2 modulus */
+         nn_zero(d, n);
+         d[n - 1] = WORD(1) << bits;
+         break;
+      case 1: /* odd modulus */
+         d[0] |= 1;
+         break;
+      default: ;
+      }
+
+      nn_random(a, state, m);
+      if (m == n) 
+         nn_divrem(q, a, n, d, n);
+      else
+         nn_zero(a + m, n - m);
+      m = nn_normalise(a, n);
+
+      ret = nn_invmod(r, a, m, d, n);
+      
+      if (ret)
+      {
+         if (m != 0) 
+         {
+            nn_mul(p, r, n, a, m);
+            nn_zero(p + n + m, n - m);
+            nn_divrem(q, p, 2*n, d, n);
+         } else
+            nn_zero(p, n);
+         
+         result = ((n == 1 && d[0] == 1) ? r[0] == 0 :
+            p[0] == 1 && nn_normalise(p + 1, n - 1) == 0) 
+               && nn_cmp_m(r, d, n) < 0;
+      } else
+      {
+         nn_copy(t1, d, n);
+         nn_copy(t2, a, m);
+         s = m == 0 ? n : nn_gcd(g, t1, n, t2, m);
+         
+         result = (m == 0 || s != 1 || g[0] != 1);
+      }
+
+      if (!result) 
+      {
+         printf("ret = %d\n", ret);
+         print_debug(a, m); print_debug(d, n); 
+         print_debug(r, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_multi_mod(void)
+{
+   int result = 1;
+   len_t m, num, i;
+   nn_t a, d, r;
+   mod_preinv1_t inv;
+   word_t r2;
+
+   printf("multi_mod...");
+
+   TEST_START(1, ITER/10) /* test r[i] = a mod d[i] */
+   {
+      randoms_upto(300, ANY, state, &m, NULL);
+      randoms_upto(200, NONZERO, state, &num, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(num, ANY, state, &d, &r, NULL);
+      
+      for (i = 0; i < num; i++)
+         if (d[i] == 0) d[i] = 1;
+
+      nn_multi_mod(r, a, m, d, num);
+      
+      for (i = 0; i < num && result; i++)
+      {
+         precompute_mod_inverse1(&inv, d[i]);
+         r2 = nn_mod1_preinv(a, m, d[i], inv);
+
+         result = (r[i] == r2);
+
+         if (!result) 
+         {
+            printf("num = %ld, i = %ld\n", num, i);
+            print_debug(a, m); print_debug(d, num);
+            printf("%lx %lx\n", r[i], r2);
+         }
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_sizeinbase(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a;
+   size_t n, len;
+   char * str;
+   int base;
+
+   printf("sizeinbase...");
+
+   TEST_START(1, ITER) /* test exact or one too large */
+   {
+      randoms_upto(40, ANY, state, &m, NULL);
+      base = randint(61, state) + 2;
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      
+      n = nn_sizeinbase(a, m, base);
+      str = nn_get_str_base(a, m, base);
+      len = strlen(str);
+
+      result = (n == len || n == len + 1);
+      if ((base & (base - 1)) == 0)
+         result &= (n == len);
+
+      if (!result) 
+      {
+         printf("base = %d, n = %lu, len = %lu\n", base, n, len);
+         print_debug(a, m);
+      }
+
+      free(str);
+   } TEST_END;
+
+   return result;
+}
+
+int test_get_str_buf(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a;
+   size_t n, cap;
+   char * str, * buf;
+
+   printf("get_str_buf...");
+
+   TEST_START(1, ITER/10) /* test get_str_buf agrees with get_str */
+   {
+      randoms_upto(100, ANY, state, &m, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      
+      cap = nn_sizeinbase(a, m, 10) + 1;
+      buf = (char *) malloc(cap);
+
+      str = nn_get_str(a, m);
+      n = nn_get_str_buf(buf, cap, a, m);
+
+      result = (n == strlen(str) && strcmp(buf, str) == 0 
+             && nn_get_str_buf(buf, cap - 1, a, m) == 0);
+
+      if (!result) 
+      {
+         printf("n = %lu, %s\n%s\n", n, str, buf);
+         print_debug(a, m);
+      }
+
+      free(str);
+      free(buf);
+   } TEST_END;
+
+   return result;
+}
+
+int test_sqr(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, r1, r2;
+
+   printf("sqr...");
+
+   TEST_START(1, ITER/10) /* test a^2 = a * a */
+   {
+      randoms_upto(1000, NONZERO, state, &m, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(2*m, ANY, state, &r1, &r2, NULL);
+      
+      nn_sqr(r1, a, m);
+      nn_mul_classical(r2, a, m, a, m);
+      
+      result = nn_equal_m(r1, r2, 2*m);
+
+      if (!result) 
+      {
+         print_debug(a, m);
+         print_debug_diff(r1, r2, 2*m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_powm(void)
+{
+   int result = 1;
+   len_t m, n, en, i;
+   nn_t a, d, e, r1, r2, t, q, s;
+   word_t w;
+
+   printf("powm...");
+
+   TEST_START(1, ITER/10) /* test against repeated multiplication */
+   {
+      randoms_upto(20, ANY, state, &m, NULL);
+      randoms_upto(20, NONZERO, state, &n, NULL);
+      randoms_upto(100, ANY, state, &w, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &d, &r1, &r2, NULL);
+      randoms_of_len(2*n, ANY, state, &t, NULL);
+      randoms_of_len(BSDNT_MAX(m, n) + 1, ANY, state, &q, &s, NULL);
+      
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_powm(r1, a, m, &w, 1, d, n);
+
+      /* r2 = a mod d */
+      nn_zero(s, BSDNT_MAX(m, n));
+      nn_copy(s, a, m);
+      nn_divrem(q, s, BSDNT_MAX(m, n), d, n);
+      
+      /* r2 = 1 mod d */
+      nn_zero(r2, n);
+      r2[0] = 1;
+      nn_divrem(q, r2, n, d, n);
+
+      for (i = 0; i < (len_t) w; i++)
+      {
+         nn_mul_m(t, r2, s, n);
+         nn_divrem(q, t, 2*n, d, n);
+         nn_copy(r2, t, n);
+      }
+
+      result = nn_equal_m(r1, r2, n);
+
+      if (!result) 
+      {
+         bsdnt_printf("w = %w\n", w);
+         print_debug(a, m); print_debug(d, n);
+         print_debug_diff(r1, r2, n);
+      }
+   } TEST_END;
+
+   TEST_START(2, ITER/10) /* test a^(e + e) = (a^e)^2 */
+   {
+      randoms_upto(20, ANY, state, &m, NULL);
+      randoms_upto(20, NONZERO, state, &n, &en, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &d, &r1, &r2, NULL);
+      randoms_of_len(en + 1, ANY, state, &e, NULL);
+      randoms_of_len(2*n, ANY, state, &t, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_powm(r1, a, m, e, en, d, n);
+      nn_sqr(t, r1, n);
+      nn_divrem(q, t, 2*n, d, n);
+      
+      e[en] = nn_add_m(e, e, e, en);
+      nn_powm(r2, a, m, e, en + 1, d, n);
+      
+      result = nn_equal_m(t, r2, n);
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(d, n); print_debug(e, en + 1);
+         print_debug_diff(t, r2, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_powm_sec(void)
+{
+   int result = 1;
+   len_t m, n, en;
+   nn_t a, d, e, r1, r2;
+
+   printf("powm_sec...");
+
+   TEST_START(1, ITER/10) /* test powm_sec agrees with powm */
+   {
+      randoms_upto(40, ANY, state, &m, &en, NULL);
+      randoms_upto(20, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &d, &r1, &r2, NULL);
+      randoms_of_len(en, ANY, state, &e, NULL);
+      
+      d[0] |= 1;
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_powm(r1, a, m, e, en, d, n);
+      nn_powm_sec(r2, a, m, e, en, d, n);
+      
+      result = nn_equal_m(r1, r2, n);
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(d, n); print_debug(e, en);
+         print_debug_diff(r1, r2, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_mod_2exp_minus_c(void)
+{
+   int result = 1;
+   len_t m, n;
+   bits_t k;
+   word_t c;
+   nn_t a, d, q, t, r;
+
+   printf("mod_2exp_minus_c...");
+
+   TEST_START(1, ITER) /* test against divrem by 2^k - c */
+   {
+      randoms_upto(400, NONZERO, state, &k, NULL);
+      k++;
+      n = (k + WORD_BITS - 1)/WORD_BITS;
+      randoms_upto(2*n + 3, ANY, state, &m, NULL);
+      randoms_upto(k <= WORD_BITS ? (WORD(1) << (k - 1)) : ~WORD(0), 
+                                                   ANY, state, &c, NULL);
+
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &d, &r, NULL);
+      randoms_of_len(BSDNT_MAX(m, n), ANY, state, &t, &q, NULL);
+      
+      nn_zero(d, n);
+      if ((k % WORD_BITS) != 0)
+         d[n - 1] = (WORD(1) << (k % WORD_BITS));
+      nn_sub1(d, d, n, c);
+
+      nn_zero(t, BSDNT_MAX(m, n));
+      nn_copy(t, a, m);
+      if (m >= n)
+         nn_divrem(q, t, m, d, n);
+
+      nn_mod_2exp_minus_c(r, a, m, k, c);
+      
+      result = nn_equal_m(r, t, n);
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %b, c = %w\n", k, c);
+         print_debug(a, m); print_debug(d, n);
+         print_debug_diff(r, t, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_sqrsub_mod_2exp_minus_c(void)
+{
+   int result = 1;
+   len_t n, iter, i;
+   bits_t k;
+   word_t c, e;
+   nn_t a, d, q, t, r;
+   bits_t primes[] = { 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607 };
+   bits_t composites[] = { 11, 23, 29, 37, 41, 43, 47, 53, 59, 67, 101 };
+
+   printf("sqrsub_mod_2exp_minus_c...");
+
+   TEST_START(1, ITER/10) /* test against squaring and divrem */
+   {
+      randoms_upto(400, NONZERO, state, &k, NULL);
+      k++;
+      n = (k + WORD_BITS - 1)/WORD_BITS;
+      randoms_upto(4, ANY, state, &iter, NULL);
+      randoms_upto(k <= WORD_BITS ? (WORD(1) << (k - 1)) : ~WORD(0), 
+                                                   ANY, state, &c, NULL);
+      randoms_upto(k <= WORD_BITS ? (WORD(1) << (k - 1)) : ~WORD(0), 
+                                                   ANY, state, &e, NULL);
+
+      randoms_of_len(n, ANY, state, &a, &d, &r, NULL);
+      randoms_of_len(2*n, ANY, state, &t, &q, NULL);
+      
+      nn_zero(d, n);
+      if ((k % WORD_BITS) != 0)
+         d[n - 1] = (WORD(1) << (k % WORD_BITS));
+      nn_sub1(d, d, n, c);
+
+      nn_divrem(q, a, n, d, n);
+
+      nn_sqrsub_mod_2exp_minus_c(r, a, k, c, e, iter);
+      
+      /* a = a^2 - e mod d, adding d first */
+      for (i = 0; i < iter; i++)
+      {
+         nn_mul_classical(t, a, n, a, n);
+         nn_add(t, t, 2*n, d, n);
+         nn_sub1(t, t, 2*n, e);
+         nn_divrem(q, t, 2*n, d, n);
+         nn_copy(a, t, n);
+      }
+
+      result = nn_equal_m(r, a, n);
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %b, c = %w, e = %w\n", k, c, e);
+         print_debug(d, n);
+         print_debug_diff(r, a, n);
+      }
+   } TEST_END;
+
+   TEST_START(2, 1) /* Lucas-Lehmer test of 2^p - 1 */
+   {
+      for (i = 0; i < (len_t) (sizeof(primes)/sizeof(bits_t)); i++)
+      {
+         n = (primes[i] + WORD_BITS - 1)/WORD_BITS;
+         randoms_of_len(n, ANY, state, &a, NULL);
+         nn_zero(a, n);
+         a[0] = 4;
+
+         nn_sqrsub_mod_2exp_minus_c(a, a, primes[i], 1, 2, primes[i] - 2);
+         
+         result &= (nn_normalise(a, n) == 0);
+      }
+
+      for (i = 0; i < (len_t) (sizeof(composites)/sizeof(bits_t)); i++)
+      {
+         n = (composites[i] + WORD_BITS - 1)/WORD_BITS;
+         randoms_of_len(n, ANY, state, &a, NULL);
+         nn_zero(a, n);
+         a[0] = 4;
+
+         nn_sqrsub_mod_2exp_minus_c(a, a, composites[i], 1, 2, 
+                                                      composites[i] - 2);
+         
+         result &= (nn_normalise(a, n) != 0);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_normmod_2expp1(void)
+{
+   int result = 1;
+   len_t n;
+   word_t w;
+   sword_t hi;
+   nn_t a, d, q, t;
+
+   printf("normmod_2expp1...");
+
+   TEST_START(1, ITER) /* test against divrem by B^n + 1 */
+   {
+      randoms_upto(40, NONZERO, state, &n, NULL);
+      randoms_upto(16, ANY, state, &w, NULL);
+      hi = (sword_t) w - 8;
+
+      randoms_of_len(n + 1, ANY, state, &a, &d, &t, &q, NULL);
+      
+      nn_zero(d, n + 1);
+      d[0] = 1;
+      d[n] = 1;
+
+      /* t = a + hi*B^n + max(-hi, 0)*(B^n + 1) >= 0 */
+      nn_copy(t, a, n);
+      t[n] = 0;
+      if (hi >= 0)
+         t[n] = hi;
+      else
+         t[n] = nn_add1(t, t, n, -hi);
+      nn_divrem(q, t, n + 1, d, n + 1);
+
+      a[n] = hi;
+      nn_normmod_2expp1(a, n);
+      
+      result = nn_equal_m(a, t, n + 1) && (a[n] == 0 || 
+                                           nn_normalise(a, n) == 0);
+
+      if (!result) 
+      {
+         bsdnt_printf("hi = %w\n", hi);
+         print_debug_diff(a, t, n + 1);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_mulmod_2expp1(void)
+{
+   int result = 1;
+   len_t n;
+   word_t w;
+   nn_t a, b, d, p, q, r;
+
+   printf("mulmod_2expp1...");
+
+   TEST_START(1, ITER) /* test against mul and divrem by B^n + 1 */
+   {
+      randoms_upto(60, NONZERO, state, &n, NULL);
+      randoms_upto(8, ANY, state, &w, NULL);
+
+      randoms_of_len(n + 1, ANY, state, &a, &b, &d, &r, NULL);
+      randoms_of_len(2*n + 2, ANY, state, &p, &q, NULL);
+      
+      nn_zero(d, n + 1);
+      d[0] = 1;
+      d[n] = 1;
+
+      a[n] = b[n] = 0;
+      if (w == 0) /* a = -1 */
+      {
+         nn_zero(a, n);
+         a[n] = 1;
+      }
+      if (w == 1) /* b = -1 */
+      {
+         nn_zero(b, n);
+         b[n] = 1;
+      }
+
+      nn_mul_classical(p, a, n + 1, b, n + 1);
+      nn_divrem(q, p, 2*n + 2, d, n + 1);
+
+      nn_mulmod_2expp1(r, a, b, n);
+      
+      result = nn_equal_m(r, p, n + 1);
+
+      if (!result) 
+      {
+         print_debug(a, n + 1); print_debug(b, n + 1);
+         print_debug_diff(r, p, n + 1);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_sqrtrem(void)
+{
+   int result = 1;
+   len_t m, n, rn;
+   word_t w, s1, r1;
+   nn_t a, s, r, t;
+
+   printf("sqrtrem...");
+
+   TEST_START(1, ITER) /* test s^2 + r = a with 0 <= r <= 2s */
+   {
+      randoms_upto(100, NONZERO, state, &m, NULL);
+      n = (m + 1)/2;
+      
+      randoms_of_len(m, FULL, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &s, NULL);
+      randoms_of_len(n + 1, ANY, state, &r, NULL);
+      randoms_of_len(2*n + 1, ANY, state, &t, NULL);
+
+      rn = nn_sqrtrem(s, r, a, m);
+
+      result = (rn == nn_normalise(r, n + 1));
+      
+      /* r <= 2s */
+      t[n] = nn_shl(t, s, n, 1);
+      result &= (nn_cmp(t, nn_normalise(t, n + 1), r, rn) >= 0);
+      
+      /* s^2 + r = a */
+      nn_sqr(t, s, n);
+      t[2*n] = 0;
+      nn_add(t, t, 2*n + 1, r, rn);
+      result &= (nn_normalise(t, 2*n + 1) == m && nn_equal_m(t, a, m));
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(s, n); print_debug(r, rn);
+      }
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test sqrtrem of a square */
+   {
+      randoms_upto(50, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(n, FULL, state, &t, NULL);
+      randoms_of_len(2*n, ANY, state, &a, NULL);
+      randoms_of_len(n, ANY, state, &s, NULL);
+      randoms_of_len(n + 1, ANY, state, &r, NULL);
+
+      nn_sqr(a, t, n);
+      m = nn_normalise(a, 2*n);
+
+      rn = nn_sqrtrem(s, r, a, m);
+
+      result = (rn == 0 && (m + 1)/2 == n && nn_equal_m(s, t, n));
+
+      if (!result) 
+      {
+         print_debug(t, n); print_debug(s, n);
+      }
+   } TEST_END;
+
+   TEST_START(3, ITER) /* test n_sqrtrem agrees with sqrtrem */
+   {
+      randoms_upto(~WORD(0), NONZERO, state, &w, NULL);
+      randoms_of_len(1, ANY, state, &s, NULL);
+      randoms_of_len(2, ANY, state, &r, NULL);
+      
+      if ((w & 1) != 0) /* also try near squares */
+         w = n_sqrt(w)*n_sqrt(w) - (w & 2)/2;
+      if (w == 0)
+         w = 1;
+
+      rn = nn_sqrtrem(s, r, &w, 1);
+      s1 = n_sqrtrem(&r1, w);
+
+      result = (s1 == s[0] && (r1 == 0 ? rn == 0 : rn == 1 && r1 == r[0]));
+
+      if (!result) 
+         bsdnt_printf("w = %w, s = %w, %w\n", w, s1, s[0]);
+   } TEST_END;
+
+   return result;
+}
+
 int test(void)
 {
    long pass = 0;
@@ -256,6 +947,19 @@ int test(void)
    RUN(test_mullow);
    RUN(test_divrem);
    RUN(test_div);
+   RUN(test_invert_hensel);
+   RUN(test_invmod);
+   RUN(test_multi_mod);
+   RUN(test_sizeinbase);
+   RUN(test_get_str_buf);
+   RUN(test_sqr);
+   RUN(test_powm);
+   RUN(test_powm_sec);
+   RUN(test_mod_2exp_minus_c);
+   RUN(test_sqrsub_mod_2exp_minus_c);
+   RUN(test_normmod_2expp1);
+   RUN(test_mulmod_2expp1);
+   RUN(test_sqrtrem);
    
    printf("%ld of %ld tests pass.\n", pass, pass + fail);
 
@@ -0,0 +1,286 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "nn.h"
+#include "test.h"
+
+#undef ITER
+#define ITER 20000
+
+rand_t state;
+
+typedef word_t (*fixed_addsub_t)(nn_t, nn_src_t, nn_src_t);
+
+#define FIXED_LEN 9
+
+len_t fixed_len[FIXED_LEN] = { 2, 3, 4, 6, 8, 12, 16, 24, 32 };
+
+fixed_addsub_t fixed_add[FIXED_LEN] = { nn_add_2, nn_add_3, nn_add_4, 
+             nn_add_6, nn_add_8, nn_add_12, nn_add_16, nn_add_24, nn_add_32 };
+
+fixed_addsub_t fixed_sub[FIXED_LEN] = { nn_sub_2, nn_sub_3, nn_sub_4, 
+             nn_sub_6, nn_sub_8, nn_sub_12, nn_sub_16, nn_sub_24, nn_sub_32 };
+
+int test_add_sub_fixed(void)
+{
+   int result = 1;
+   len_t i, m;
+   word_t ci1, ci2;
+   nn_t a, b, r1, r2;
+
+   printf("add_sub_fixed...");
+
+   TEST_START(1, ITER) /* test add and sub kernels against add_m, sub_m */
+   {
+      randoms_upto(FIXED_LEN, ANY, state, &i, NULL);
+      m = fixed_len[i];
+
+      randoms_of_len(m, FULL, state, &a, &b, NULL);
+      randoms_of_len(m, ANY, state, &r1, &r2, NULL);
+
+      ci1 = nn_add_m(r1, a, b, m);
+      ci2 = fixed_add[i](r2, a, b);
+
+      result = (ci1 == ci2 && nn_equal_m(r1, r2, m));
+
+      ci1 = nn_sub_m(r1, a, b, m);
+      ci2 = fixed_sub[i](r2, a, b);
+
+      result &= (ci1 == ci2 && nn_equal_m(r1, r2, m));
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(b, m);
+         print_debug_diff(r1, r2, m);
+      }
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test aliasing */
+   {
+      randoms_upto(FIXED_LEN, ANY, state, &i, NULL);
+      m = fixed_len[i];
+
+      randoms_of_len(m, ANY, state, &a, &b, &r1, NULL);
+
+      ci1 = nn_add_m(r1, a, b, m);
+      ci2 = fixed_add[i](a, a, b);
+
+      result = (ci1 == ci2 && nn_equal_m(r1, a, m));
+
+      if (!result) 
+      {
+         print_debug(b, m);
+         print_debug_diff(r1, a, m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_mul_fixed(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, b, r1, r2;
+
+   printf("mul_fixed...");
+
+   TEST_START(1, ITER) /* test mul_fixed against mul_classical */
+   {
+      randoms_upto(NN_FIXED_MAX + 2, NONZERO, state, &m, NULL);
+
+      randoms_of_len(m, FULL, state, &a, &b, NULL);
+      randoms_of_len(2*m, ANY, state, &r1, &r2, NULL);
+
+      nn_mul_classical(r1, a, m, b, m);
+      nn_mul_fixed(r2, a, b, m);
+
+      result = nn_equal_m(r1, r2, 2*m);
+
+      if (!result) 
+      {
+         print_debug(a, m); print_debug(b, m);
+         print_debug_diff(r1, r2, 2*m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_sqr_fixed(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, r1, r2;
+
+   printf("sqr_fixed...");
+
+   TEST_START(1, ITER) /* test sqr_fixed against mul_classical */
+   {
+      randoms_upto(NN_FIXED_MAX + 2, NONZERO, state, &m, NULL);
+
+      randoms_of_len(m, FULL, state, &a, NULL);
+      randoms_of_len(2*m, ANY, state, &r1, &r2, NULL);
+
+      nn_mul_classical(r1, a, m, a, m);
+      nn_sqr_fixed(r2, a, m);
+
+      result = nn_equal_m(r1, r2, 2*m);
+
+      if (!result) 
+      {
+         print_debug(a, m);
+         print_debug_diff(r1, r2, 2*m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_redc_fixed(void)
+{
+   int result = 1;
+   len_t n;
+   nn_t a, b, d, q, t1, t2, r1, r2;
+   hensel_preinv1_t dinv;
+
+   printf("redc_fixed...");
+
+   TEST_START(1, ITER) /* test redc_fixed against redc_classical */
+   {
+      randoms_upto(NN_FIXED_MAX + 2, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(n, ANY, state, &a, &b, &d, &r1, &r2, NULL);
+      randoms_of_len(2*n, ANY, state, &t1, &t2, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      d[0] |= 1;
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_divrem(q, a, n, d, n);
+      nn_divrem(q, b, n, d, n);
+
+      precompute_hensel_inverse1(&dinv, d[0]);
+
+      nn_mul_classical(t1, a, n, b, n);
+      nn_copy(t2, t1, 2*n);
+
+      nn_redc_classical(r1, t1, d, n, dinv);
+      nn_redc_fixed(r2, t2, d, n, dinv);
+      
+      result = nn_equal_m(r1, r2, n);
+
+      if (!result) 
+      {
+         print_debug(a, n); print_debug(b, n); print_debug(d, n);
+         print_debug_diff(r1, r2, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_mont_mul_fixed(void)
+{
+   int result = 1;
+   len_t n;
+   nn_t a, b, d, q, r1, r2;
+   hensel_preinv1_t dinv;
+
+   printf("mont_mul_fixed...");
+
+   TEST_START(1, ITER) /* test mont_mul_fixed against mont_mul */
+   {
+      randoms_upto(NN_FIXED_MAX + 2, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(n, ANY, state, &a, &b, &d, &r1, &r2, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      d[0] |= 1;
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_divrem(q, a, n, d, n);
+      nn_divrem(q, b, n, d, n);
+
+      precompute_hensel_inverse1(&dinv, d[0]);
+
+      nn_mont_mul(r1, a, b, d, n, dinv);
+      nn_mont_mul_fixed(r2, a, b, d, n, dinv);
+      
+      result = nn_equal_m(r1, r2, n);
+
+      /* squaring, with the output aliasing the input */
+      nn_mont_mul(r1, a, a, d, n, dinv);
+      nn_mont_mul_fixed(a, a, a, d, n, dinv);
+      
+      result &= nn_equal_m(r1, a, n);
+
+      if (!result) 
+      {
+         print_debug(b, n); print_debug(d, n);
+         print_debug_diff(r1, r2, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_fixed(void)
+{
+   long pass = 0;
+   long fail = 0;
+   
+   RUN(test_add_sub_fixed);
+   RUN(test_mul_fixed);
+   RUN(test_sqr_fixed);
+   RUN(test_redc_fixed);
+   RUN(test_mont_mul_fixed);
+   
+   printf("%ld of %ld tests pass.\n", pass, pass + fail);
+
+   return (fail != 0);
+}
+
+int main(void)
+{
+   int ret = 0;
+   
+   printf("\nTesting nn_fixed functions:\n");
+   
+   randinit(&state);
+   checkpoint_rand("First Random Word: ");
+
+   ret = test_fixed();
+
+   randclear(state);
+
+   return ret;
+}
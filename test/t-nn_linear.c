@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "nn.h"
 #include "test.h"
 
@@ -1643,6 +1644,154 @@ int test_mod1_preinv(void)
    return result;
 }
 
+int test_get_set_str_pow2(void)
+{
+   int result = 1;
+   len_t m, m2;
+   nn_t a, b;
+   char * str1, * str2;
+   size_t digits, i;
+   bits_t k;
+
+   printf("get/set_str_pow2...");
+
+   TEST_START(1, ITER/10) /* test against the general base code */
+   {
+      randoms_upto(50, NONZERO, state, &m, NULL);
+      randoms_upto(6, NONZERO, state, &k, NULL);
+      
+      randoms_of_len(m, FULL, state, &a, NULL);
+      randoms_of_len(m + 1, ANY, state, &b, NULL);
+
+      str1 = (char *) malloc(m*WORD_BITS + 1);
+      str2 = (char *) malloc(m*WORD_BITS + 1);
+
+      digits = nn_get_str_pow2(str1, a, m, k);
+      
+      nn_copy(b, a, m);
+      nn_get_str_base_classical(str2, digits, b, m, 1 << k);
+
+      result = (strncmp(str1, str2, digits) == 0 && str1[0] != '0');
+
+      m2 = nn_set_str_pow2(b, str1, digits, k);
+      result &= (m2 == m && nn_equal_m(a, b, m));
+
+      if (k == 4) /* decoding is case insensitive */
+      {
+         for (i = 0; i < digits; i++)
+            if (str1[i] >= 'a') str1[i] += 'A' - 'a';
+         
+         m2 = nn_set_str_pow2(b, str1, digits, k);
+         result &= (m2 == m && nn_equal_m(a, b, m));
+      }
+
+      m2 = nn_set_str_base_classical(b, str1, digits, 1 << k);
+      result &= (m2 == m && nn_equal_m(a, b, m));
+
+      if (!result) 
+      {
+         printf("k = %ld\n", k);
+         print_debug(a, m); print_debug(b, m2);
+      }
+
+      free(str1);
+      free(str2);
+   } TEST_END;
+
+   return result;
+}
+
+int test_cnd(void)
+{
+   int result = 1;
+   nn_t a, b, r1, r2, s1, s2;
+   len_t m;
+   word_t cnd, c1, c2;
+
+   printf("nn_cnd_add/sub/swap...");
+
+   /* test cnd_add agrees with add_m or copy */
+   TEST_START(1, ITER) 
+   {
+      randoms_upto(100, ANY, state, &m, NULL);
+      cnd = randint(2, state) ? randword(state) : 0;
+
+      randoms_of_len(m, ANY, state, &a, &b, &r1, &r2, NULL);
+      
+      c1 = nn_cnd_add(r1, a, b, m, cnd);
+      
+      if (cnd)
+         c2 = nn_add_m(r2, a, b, m);
+      else
+      {
+         nn_copy(r2, a, m);
+         c2 = 0;
+      }
+
+      result = (c1 == c2 && nn_equal_m(r1, r2, m));
+
+      if (!result) 
+      {
+         bsdnt_printf("cnd = %wx\n", cnd);
+         print_debug(a, m); print_debug(b, m); 
+         print_debug_diff(r1, r2, m);
+      }
+   } TEST_END;
+
+   /* test cnd_sub agrees with sub_m or copy */
+   TEST_START(2, ITER) 
+   {
+      randoms_upto(100, ANY, state, &m, NULL);
+      cnd = randint(2, state) ? randword(state) : 0;
+
+      randoms_of_len(m, ANY, state, &a, &b, &r1, &r2, NULL);
+      
+      c1 = nn_cnd_sub(r1, a, b, m, cnd);
+      
+      if (cnd)
+         c2 = nn_sub_m(r2, a, b, m);
+      else
+      {
+         nn_copy(r2, a, m);
+         c2 = 0;
+      }
+
+      result = (c1 == c2 && nn_equal_m(r1, r2, m));
+
+      if (!result) 
+      {
+         bsdnt_printf("cnd = %wx\n", cnd);
+         print_debug(a, m); print_debug(b, m); 
+         print_debug_diff(r1, r2, m);
+      }
+   } TEST_END;
+
+   /* test cnd_swap swaps exactly when cnd is nonzero */
+   TEST_START(3, ITER) 
+   {
+      randoms_upto(100, ANY, state, &m, NULL);
+      cnd = randint(2, state) ? randword(state) : 0;
+
+      randoms_of_len(m, ANY, state, &a, &b, &s1, &s2, NULL);
+      
+      nn_copy(s1, a, m);
+      nn_copy(s2, b, m);
+      nn_cnd_swap(s1, s2, m, cnd);
+
+      result = (nn_equal_m(s1, cnd ? b : a, m) 
+             && nn_equal_m(s2, cnd ? a : b, m));
+
+      if (!result) 
+      {
+         bsdnt_printf("cnd = %wx\n", cnd);
+         print_debug(a, m); print_debug(b, m); 
+         print_debug(s1, m); print_debug(s2, m); 
+      }
+   } TEST_END;
+
+   return result;
+}
+
 int test_linear(void)
 {
    long pass = 0;
@@ -1660,6 +1809,7 @@ int test_linear(void)
    RUN(test_sub1);
    RUN(test_sub_m);
    RUN(test_sub);
+   RUN(test_cnd);
    RUN(test_shl);
    RUN(test_shr);
    RUN(test_copy);
@@ -1676,6 +1826,7 @@ int test_linear(void)
    RUN(test_divrem1_preinv);
    RUN(test_divrem_hensel1_preinv);
    RUN(test_mod1_preinv);
+   RUN(test_get_set_str_pow2);
    
    printf("%ld of %ld tests pass.\n", pass, pass + fail);
 
@@ -607,12 +607,140 @@ int test_get_set_str(void)
    return result;
 }
 
+int test_sqr_classical(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, r1, r2;
+
+   printf("sqr_classical...");
+
+   TEST_START(1, ITER) /* test a^2 = a * a */
+   {
+      randoms_upto(50, NONZERO, state, &m, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, NULL);
+      randoms_of_len(2*m, ANY, state, &r1, &r2, NULL);
+      
+      nn_sqr_classical(r1, a, m);
+      nn_mul_classical(r2, a, m, a, m);
+      
+      result = nn_equal_m(r1, r2, 2*m);
+
+      if (!result) 
+      {
+         print_debug(a, m);
+         print_debug_diff(r1, r2, 2*m);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_redc_classical(void)
+{
+   int result = 1;
+   len_t n;
+   nn_t a, b, d, t, r, s, q;
+   hensel_preinv1_t dinv;
+
+   printf("redc_classical...");
+
+   TEST_START(1, ITER) /* test redc(a*b)*B^n = a*b mod d */
+   {
+      randoms_upto(30, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(n, ANY, state, &a, &b, &d, &r, NULL);
+      randoms_of_len(2*n, ANY, state, &t, &s, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      d[0] |= 1;
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      /* reduce a and b mod d */
+      nn_divrem(q, a, n, d, n);
+      nn_divrem(q, b, n, d, n);
+
+      precompute_hensel_inverse1(&dinv, d[0]);
+
+      nn_mul_classical(t, a, n, b, n);
+      nn_copy(s, t, 2*n);
+      nn_redc_classical(r, t, d, n, dinv);
+      
+      result = (nn_cmp_m(r, d, n) < 0);
+
+      /* t = r*B^n mod d, s = a*b mod d */
+      nn_zero(t, n);
+      nn_copy(t + n, r, n);
+      nn_divrem(q, t, 2*n, d, n);
+      nn_divrem(q, s, 2*n, d, n);
+      
+      result &= nn_equal_m(t, s, n);
+
+      if (!result) 
+      {
+         print_debug(a, n); print_debug(b, n); print_debug(d, n);
+         print_debug_diff(t, s, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
+int test_redc_sec_classical(void)
+{
+   int result = 1;
+   len_t n;
+   nn_t a, b, d, t1, t2, r1, r2, q;
+   hensel_preinv1_t dinv;
+
+   printf("redc_sec_classical...");
+
+   TEST_START(1, ITER) /* test redc_sec agrees with redc */
+   {
+      randoms_upto(30, NONZERO, state, &n, NULL);
+      
+      randoms_of_len(n, ANY, state, &a, &b, &d, &r1, &r2, NULL);
+      randoms_of_len(2*n, ANY, state, &t1, &t2, NULL);
+      randoms_of_len(n + 1, ANY, state, &q, NULL);
+      
+      d[0] |= 1;
+      if (d[n - 1] == 0) 
+         d[n - 1] = 1;
+
+      nn_divrem(q, a, n, d, n);
+      nn_divrem(q, b, n, d, n);
+
+      precompute_hensel_inverse1(&dinv, d[0]);
+
+      nn_mul_classical(t1, a, n, b, n);
+      nn_copy(t2, t1, 2*n);
+      
+      nn_redc_classical(r1, t1, d, n, dinv);
+      nn_redc_sec_classical(r2, t2, d, n, dinv);
+      
+      result = nn_equal_m(r1, r2, n);
+
+      if (!result) 
+      {
+         print_debug(a, n); print_debug(b, n); print_debug(d, n);
+         print_debug_diff(r1, r2, n);
+      }
+   } TEST_END;
+
+   return result;
+}
+
 int test_quadratic(void)
 {
    long pass = 0;
    long fail = 0;
    
    RUN(test_mul_classical);
+   RUN(test_sqr_classical);
+   RUN(test_redc_classical);
+   RUN(test_redc_sec_classical);
    RUN(test_mullow_classical);
    RUN(test_mulmid_classical);
    RUN(test_divrem_classical_preinv);
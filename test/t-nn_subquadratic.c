@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "nn.h"
 #include "test.h"
 
@@ -393,6 +394,93 @@ int test_divrem_divconquer_preinv(void)
    return result;
 }
 
+int test_get_str_divconquer(void)
+{
+   int result = 1;
+   len_t m;
+   nn_t a, b;
+   char * str1, * str2;
+   size_t digits;
+
+   printf("get_str_divconquer...");
+
+   TEST_START(1, ITER/20) /* test divconquer is the same as classical */
+   {
+      randoms_upto(400, NONZERO, state, &m, NULL);
+      
+      randoms_of_len(m, ANY, state, &a, &b, NULL);
+      
+      /* allow for leading zeroes */
+      digits = (size_t) (m*WORD_BITS*0.30103) + 1 + randint(40, state);
+      str1 = (char *) malloc(digits + 1);
+      str2 = (char *) malloc(digits + 1);
+      str1[digits] = str2[digits] = '\0';
+
+      nn_copy(b, a, m);
+      nn_get_str_classical(str1, digits, b, m);
+      nn_copy(b, a, m);
+      nn_get_str_divconquer(str2, digits, b, m);
+      
+      result = (strcmp(str1, str2) == 0);
+
+      if (!result) 
+      {
+         print_debug(a, m);
+         printf("%s\n%s\n", str1, str2);
+      }
+
+      free(str1);
+      free(str2);
+   } TEST_END;
+
+   return result;
+}
+
+int test_set_str_divconquer(void)
+{
+   int result = 1;
+   len_t m1, m2;
+   nn_t a, b;
+   char * str;
+   size_t digits, i;
+
+   printf("set_str_divconquer...");
+
+   TEST_START(1, ITER/20) /* test divconquer is the same as classical */
+   {
+      randoms_upto(40000, NONZERO, state, &digits, NULL);
+      
+      str = (char *) malloc(digits + 1);
+      
+      for (i = 0; i < digits; i++)
+         str[i] = '0' + (char) randint(10, state);
+      str[digits] = '\0';
+
+      if (randint(4, state) == 0) /* leading zeroes */
+         for (i = 0; i < digits/2; i++) 
+            str[i] = '0';
+
+      m1 = (len_t) (digits*3.321928094887362/WORD_BITS) + 1;
+      randoms_of_len(m1, ANY, state, &a, &b, NULL);
+
+      m1 = nn_set_str_classical(a, str, digits);
+      m2 = nn_set_str_divconquer(b, str, digits);
+      
+      result = (m1 == m2 && nn_equal_m(a, b, m1) 
+                && (m1 == 0 || a[m1 - 1] != 0));
+
+      if (!result) 
+      {
+         printf("%s\n", str);
+         printf("m1 = %ld, m2 = %ld\n", m1, m2);
+      }
+
+      free(str);
+   } TEST_END;
+
+   return result;
+}
+
 int test_subquadratic(void)
 {
    long pass = 0;
@@ -407,6 +495,8 @@ int test_subquadratic(void)
    RUN(test_divapprox_divconquer_preinv);
    RUN(test_div_divconquer_preinv);
    RUN(test_divrem_divconquer_preinv);
+   RUN(test_get_str_divconquer);
+   RUN(test_set_str_divconquer);
    
    printf("%ld of %ld tests pass.\n", pass, pass + fail);
 
@@ -0,0 +1,229 @@
+/* 
+  Copyright (C) 2026 agent
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, 
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in the
+	 documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__MINGW32__)
+#include <io.h>
+#endif
+#include <unistd.h>
+#include "nn.h"
+#include "zz.h"
+#include "store.h"
+#include "test.h"
+
+#undef ITER
+#define ITER 500
+
+rand_t state;
+
+/* create an empty temporary file and return its path in path */
+void temp_path(char * path)
+{
+#if defined(__MINGW32__)
+   strcpy(path, "t-storeXXXXXX");
+   _mktemp(path);
+#else
+   strcpy(path, "/tmp/t-storeXXXXXX");
+   close(mkstemp(path));
+#endif
+}
+
+int test_write_open(void)
+{
+   int result = 1;
+   zz_struct * a;
+   zz_t b;
+   len_t m, count, i;
+   nn_src_t e;
+   char path[32];
+   store_t S;
+   
+   printf("store_write/open...");
+
+   temp_path(path);
+
+   TEST_START(1, ITER) /* test entries read back equal those written */
+   {
+      randoms_upto(300, ANY, state, &count, NULL);
+      
+      a = (zz_struct *) malloc(BSDNT_MAX(count, 1)*sizeof(zz_struct));
+      
+      for (i = 0; i < count; i++)
+      {
+         zz_init(a + i);
+         zz_random(a + i, state, randint(20, state));
+      }
+
+      result = (store_write(path, a, count) == 0 
+             && store_open(S, path) == 0 
+             && store_count(S) == (size_t) count);
+
+      zz_init(b);
+
+      for (i = 0; i < count && result; i++)
+      {
+         e = store_entry(S, i, &m);
+         store_get_zz(b, S, i);
+
+         result = (m == BSDNT_ABS(a[i].size) 
+                && nn_cmp_m(e, a[i].n, m) == 0
+                && ((size_t) e % sizeof(word_t)) == 0
+                && (m*sizeof(word_t) < STORE_ALIGN || (size_t) e % STORE_ALIGN == 0)
+                && store_sign(S, i) == ((a[i].size > 0) - (a[i].size < 0))
+                && zz_equal(a + i, b));
+
+         if (!result)
+         {
+            printf("i = %ld, m = %ld\n", i, m);
+            zz_print(a + i); printf("\n");
+            zz_print_debug(b);
+         }
+      }
+
+      if (result)
+         store_close(S);
+
+      zz_clear(b);
+
+      for (i = 0; i < count; i++)
+         zz_clear(a + i);
+      free(a);
+   } TEST_END;
+
+   remove(path);
+
+   return result;
+}
+
+int test_invalid(void)
+{
+   int result = 1;
+   zz_t a;
+   char path[32];
+   store_t S;
+   FILE * f;
+   long pos;
+   int64_t size = INT64_MIN;
+   
+   printf("store_open invalid...");
+
+   temp_path(path);
+
+   TEST_START(1, ITER/10) /* test damaged or truncated files are rejected */
+   {
+      zz_init(a);
+      zz_random(a, state, randint(20, state) + 1);
+      if (zz_is_zero(a))
+         zz_seti(a, 1);
+
+      store_write(path, a, 1);
+      
+      f = fopen(path, "r+b");
+      fseek(f, 0, SEEK_END);
+      pos = randint(ftell(f), state);
+      
+      /* 
+         set the top limb of the entry to zero, damage a byte, truncate
+         or set the size of the entry to INT64_MIN
+      */
+      switch (randint(4, state))
+      {
+      case 0:
+         fseek(f, -(long) sizeof(word_t), SEEK_END);
+         fwrite("\0\0\0\0\0\0\0\0", 1, sizeof(word_t), f);
+         fclose(f);
+         break;
+      case 1:
+         pos = randint(STORE_HEADER_BYTES + sizeof(store_index_t), state);
+         fseek(f, pos, SEEK_SET);
+         pos = getc(f);
+         fseek(f, -1, SEEK_CUR);
+         putc((int) (pos ^ 0x80), f);
+         fclose(f);
+         pos = -1;
+         break;
+      case 2:
+         fseek(f, STORE_HEADER_BYTES + offsetof(store_index_t, size), SEEK_SET);
+         fwrite(&size, sizeof(size), 1, f);
+         fclose(f);
+         break;
+      default:
+         fclose(f);
+         if (truncate(path, pos) != 0)
+            pos = -1;
+      }
+
+      if (pos >= 0) /* the damaged byte may be padding */
+         result = (store_open(S, path) != 0);
+      else if (store_open(S, path) == 0)
+         store_close(S);
+
+      if (!result)
+      {
+         printf("pos = %ld\n", pos);
+         zz_print_debug(a);
+      }
+
+      zz_clear(a);
+   } TEST_END;
+
+   remove(path);
+
+   return result;
+}
+
+int test(void)
+{
+   long pass = 0;
+   long fail = 0;
+   
+   RUN(test_write_open);
+   RUN(test_invalid);
+   
+   printf("%ld of %ld tests pass.\n", pass, pass + fail);
+
+   return (fail != 0);
+}
+
+int main(void)
+{
+   int ret = 0;
+   
+   printf("\nTesting store functions:\n");
+   
+   randinit(&state);
+   checkpoint_rand("First Random Word: ");
+
+   ret = test();
+
+   randclear(state);
+
+   return ret;
+}
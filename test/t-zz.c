@@ -1497,6 +1497,344 @@ int test_xgcd(void)
    return result;
 }
 
+int test_invert(void)
+{
+   int result = 1;
+   zz_t a, m, r, g, t1, t2;
+   len_t m1, m2;
+   int ret;
+   
+   printf("zz_invert...");
+
+   /* test a*r = 1 mod m, or gcd(a, m) != 1 */
+   TEST_START(1, ITER/5) 
+   {
+      randoms_upto(10, ANY, state, &m1, &m2, NULL);
+         
+      randoms_signed(0, ANY, state, &r, &g, &t1, &t2, NULL);
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(m2, ANY, state, &m, NULL);
+      
+      if (randint(4, state) == 0) /* power of 2 modulus */
+      {
+         zz_seti(t1, 1);
+         zz_mul_2exp(m, t1, randint(m2*WORD_BITS + 1, state));
+      }
+
+      ret = zz_invert(r, a, m);
+      zz_gcd(g, a, m);
+
+      if (ret)
+      {
+         zz_mul(t1, a, r);
+         zz_subi(t1, t1, 1);
+         zz_divrem(t2, t1, t1, m);
+         
+         result = (zz_is_zero(t1) && zz_cmpi(r, 0) >= 0 
+                && zz_cmpabs(r, m) < 0 && (zz_equali(g, 1) 
+                 || zz_equali(g, -1) || zz_equali(m, 1) || zz_equali(m, -1)));
+      } else
+         result = (zz_is_zero(m) || (!zz_equali(g, 1) && !zz_equali(g, -1)));
+
+      if (!result) 
+      {
+         printf("ret = %d\n", ret);
+         zz_print_debug(a); zz_print_debug(m); 
+         zz_print_debug(r); zz_print_debug(g); 
+      }
+
+      gc_cleanup();
+   } TEST_END;
+   
+   /* test aliasing */
+   TEST_START(aliasing, ITER/5) 
+   {
+      randoms_upto(10, NONZERO, state, &m1, &m2, NULL);
+
+      randoms_signed(0, ANY, state, &r, &g, NULL);
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(m2, NONZERO, state, &m, NULL);
+      
+      zz_gcd(g, a, m);
+      while (!zz_equali(g, 1) && !zz_equali(g, -1)) 
+      {
+         /* r is only written if an inverse exists */
+         zz_random(a, state, m1);
+         zz_gcd(g, a, m);
+      }
+     
+      test_zz_aliasing_12(zz_invert, r, a, m);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_batch_gcd(void)
+{
+   int result = 1;
+   zz_t a[20], r1[20], r2[20], f, p, t;
+   zz_ptr out[20];
+   zz_srcptr in[20];
+   len_t m1, m2, n, i, j, chunk;
+   
+   printf("zz_batch_gcd...");
+
+   /* test against the naive all pairs algorithm */
+   TEST_START(1, ITER/50) 
+   {
+      randoms_upto(21, NONZERO, state, &n, NULL);
+      randoms_upto(n + 1, NONZERO, state, &chunk, NULL);
+      randoms_upto(4, NONZERO, state, &m1, &m2, NULL);
+
+      randoms_signed(m1, POSITIVE, state, &f, NULL);
+      randoms_signed(0, ANY, state, &p, &t, NULL);
+
+      for (i = 0; i < n; i++)
+      {
+         zz_init(a[i]);
+         zz_init(r1[i]);
+         zz_init(r2[i]);
+
+         do zz_random(a[i], state, m2); while (zz_is_zero(a[i]));
+         
+         if (randint(3, state) == 0) /* introduce a shared factor */
+            zz_mul(a[i], a[i], f);
+
+         in[i] = a[i];
+      }
+
+      for (i = 0; i < n; i++)
+      {
+         zz_seti(p, 1);
+         for (j = 0; j < n; j++)
+            if (j != i) zz_mul(p, p, a[j]);
+         zz_gcd(r1[i], a[i], p);
+      }
+
+      for (i = 0; i < n; i++)
+         out[i] = r2[i];
+
+      if (randint(2, state))
+         zz_batch_gcd(out, in, n);
+      else
+         zz_batch_gcd_chunked(out, in, n, chunk);
+
+      for (i = 0; i < n && result; i++)
+      {
+         result = zz_equal(r1[i], r2[i]);
+
+         if (!result) 
+         {
+            printf("n = %ld, chunk = %ld, i = %ld\n", n, chunk, i);
+            zz_print_debug(a[i]); zz_print_debug(r1[i]); zz_print_debug(r2[i]);
+         }
+      }
+
+      /* test aliasing of out and in */
+      for (i = 0; i < n; i++)
+         out[i] = a[i];
+      
+      zz_batch_gcd_chunked(out, in, n, chunk);
+      
+      for (i = 0; i < n && result; i++)
+      {
+         result = zz_equal(r1[i], a[i]);
+         
+         if (!result) 
+            printf("Aliasing of out and in failed\n");
+      }
+
+      for (i = 0; i < n; i++)
+      {
+         zz_clear(a[i]);
+         zz_clear(r1[i]);
+         zz_clear(r2[i]);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+   
+   return result;
+}
+
+int test_crt(void)
+{
+   int result = 1;
+   zz_t mods[20], res[20], x, r, g, q, t, M;
+   zz_srcptr mp[20], rp[20];
+   zz_crt_ctx_t ctx;
+   len_t m1, n, i, j;
+   int sym;
+   
+   printf("zz_crt...");
+
+   /* test that x is reconstructed from its residues */
+   TEST_START(1, ITER/50) 
+   {
+      randoms_upto(21, NONZERO, state, &n, NULL);
+      randoms_upto(4, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(0, ANY, state, &x, &r, &g, &q, &t, &M, NULL);
+
+      zz_seti(M, 1);
+      
+      for (i = 0; i < n; i++)
+      {
+         zz_init(mods[i]);
+         zz_init(res[i]);
+
+         /* generate pairwise coprime moduli */
+         do
+         {
+            do zz_random(mods[i], state, m1); while (zz_is_zero(mods[i]));
+            zz_gcd(g, mods[i], M);
+         } while (!zz_equali(g, 1));
+
+         zz_mul(M, M, mods[i]);
+         mp[i] = mods[i];
+         rp[i] = res[i];
+      }
+
+      sym = randint(2, state);
+      zz_random(x, state, BSDNT_ABS(M->size) + 1);
+      zz_divrem(q, x, x, M);
+      zz_mul_2exp(t, x, 1);
+      if (sym && zz_cmp(t, M) > 0)
+         zz_sub(x, x, M);
+
+      for (i = 0; i < n; i++)
+      {
+         /* residues need not be reduced, nor nonnegative */
+         zz_divrem(q, res[i], x, mods[i]);
+         zz_random(t, state, 2);
+         if (randint(2, state))
+            zz_neg(t, t);
+         zz_mul(t, t, mods[i]);
+         zz_add(res[i], res[i], t);
+      }
+      
+      zz_crt_ctx_init(ctx, mp, n);
+      
+      j = randint(n + 1, state);
+      if (j < n) /* test aliasing of r and a residue */
+      {
+         zz_set(t, res[j]);
+         zz_crt(res[j], rp, ctx, sym);
+         zz_set(r, res[j]);
+         zz_set(res[j], t);
+      } else
+         zz_crt(r, rp, ctx, sym);
+
+      result = zz_equal(r, x);
+
+      if (!result) 
+      {
+         printf("n = %ld, sym = %d\n", n, sym);
+         zz_print_debug(M); zz_print_debug(x); zz_print_debug(r);
+      }
+      
+      zz_crt_ctx_clear(ctx);
+
+      for (i = 0; i < n; i++)
+      {
+         zz_clear(mods[i]);
+         zz_clear(res[i]);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+   
+   /* test negative multi-word residues give a reduced result */
+   TEST_START(2, ITER/50) 
+   {
+      randoms_upto(3, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(0, ANY, state, &x, &g, &M, NULL);
+      
+      for (i = 0; i < 2; i++)
+      {
+         zz_init(mods[i]);
+         zz_init(res[i]);
+         mp[i] = mods[i];
+         rp[i] = res[i];
+      }
+
+      /* consecutive moduli are coprime */
+      do zz_random(mods[0], state, m1 + 1); while (zz_is_zero(mods[0]));
+      if (mods[0]->size < 0)
+         zz_neg(mods[0], mods[0]);
+      zz_addi(mods[1], mods[0], 1);
+      zz_mul(M, mods[0], mods[1]);
+
+      /* x = -1 mod m1, x = 0 mod m2 */
+      zz_seti(res[0], -1);
+      zz_seti(res[1], 0);
+      
+      zz_crt_ctx_init(ctx, mp, 2);
+      zz_crt(x, rp, ctx, 0);
+      
+      zz_sub(g, M, mods[1]);
+      result = zz_equal(x, g);
+
+      if (!result) 
+      {
+         zz_print_debug(mods[0]); zz_print_debug(x); zz_print_debug(g);
+      }
+      
+      zz_crt_ctx_clear(ctx);
+
+      for (i = 0; i < 2; i++)
+      {
+         zz_clear(mods[i]);
+         zz_clear(res[i]);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+   
+   return result;
+}
+
+int test_get_set_str_base(void)
+{
+   int result = 1;
+   zz_t a, b;
+   len_t m1;
+   char * str;
+   size_t digits;
+   int base;
+   
+   printf("zz_get/set_str_base...");
+
+   TEST_START(1, ITER/10) 
+   {
+      randoms_upto(30, ANY, state, &m1, NULL);
+      base = randint(61, state) + 2;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &b, NULL);
+      
+      str = zz_get_str_base(a, base);
+      digits = zz_set_str_base(b, str, base);
+      
+      result = (zz_equal(a, b) && digits == strlen(str));
+
+      if (!result) 
+      {
+         printf("base = %d, %s\n", base, str);
+         zz_print_debug(a); zz_print_debug(b);
+      }
+
+      free(str);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
 int test_get_set_str(void)
 {
    int result = 1;
@@ -1534,6 +1872,1216 @@ int test_get_set_str(void)
 }
 
 
+int test_out_str(void)
+{
+   int result = 1;
+   zz_t a;
+   len_t m1;
+   char * str, * buf;
+   size_t n, len, i;
+   word_t r;
+   FILE * f;
+   
+   printf("zz_out_str...");
+
+   TEST_START(1, ITER/10) /* test out_str agrees with get_str */
+   {
+      randoms_upto(300, ANY, state, &m1, NULL);
+      randoms_upto(2, ANY, state, &r, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      
+      if (r) /* 10^k + 1, with long runs of zero digits */
+      {
+         len = randint(5000, state) + 2;
+         buf = (char *) malloc(len + 1);
+         
+         buf[0] = buf[len - 1] = '1';
+         for (i = 1; i < len - 1; i++)
+            buf[i] = '0';
+         buf[len] = '\0';
+         
+         zz_set_str(a, buf);
+         free(buf);
+      }
+
+      str = zz_get_str(a);
+      len = strlen(str);
+      
+      f = tmpfile();
+      n = zz_out_str(f, a);
+      
+      buf = (char *) malloc(len + 2);
+      rewind(f);
+      buf[fread(buf, 1, len + 1, f)] = '\0';
+      fclose(f);
+
+      result = (n == len && strcmp(buf, str) == 0);
+
+      if (!result) 
+      {
+         printf("n = %lu\n%s\n%s\n", n, str, buf);
+         zz_print_debug(a);
+      }
+
+      free(buf);
+      free(str);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_set_strn(void)
+{
+   int result = 1;
+   zz_t a, b;
+   len_t m1;
+   char * str;
+   size_t n, len;
+   
+   printf("zz_set_strn...");
+
+   TEST_START(1, ITER/10) /* test set_strn on a prefix agrees with set_str */
+   {
+      randoms_upto(30, ANY, state, &m1, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &b, NULL);
+      
+      str = zz_get_str(a);
+      len = strlen(str);
+      n = randint(len, state) + 1;
+      
+      /* a sign alone is not parsed */
+      if (n == 1 && str[0] == '-')
+         result = (zz_set_strn(a, str, n) == 0 && zz_is_zero(a));
+      else
+      {
+         result = (zz_set_strn(a, str, n) == n);
+
+         str[n] = '\0';
+         zz_set_str(b, str);
+
+         result &= zz_equal(a, b);
+      }
+
+      if (!result) 
+      {
+         printf("n = %lu, %s\n", n, str);
+         zz_print_debug(a); zz_print_debug(b);
+      }
+
+      free(str);
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, 1) /* test a sign not followed by a digit is not parsed */
+   {
+      randoms_signed(0, ANY, state, &a, NULL);
+      
+      zz_seti(a, 1);
+      result = (zz_set_strn(a, "-", 1) == 0 && zz_is_zero(a));
+      
+      zz_seti(a, 1);
+      result &= (zz_set_strn(a, "-x1", 3) == 0 && zz_is_zero(a));
+
+      zz_seti(a, 1);
+      result &= (zz_set_strn(a, "-12", 1) == 0 && zz_is_zero(a));
+
+      result &= (zz_set_strn(a, "-12", 3) == 3 && zz_equali(a, -12));
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_inp_str(void)
+{
+   int result = 1;
+   zz_t a, b;
+   len_t m1;
+   char * str;
+   size_t n, len;
+   FILE * f;
+   
+   printf("zz_inp_str...");
+
+   TEST_START(1, ITER/50) /* test inp_str agrees with set_str */
+   {
+      randoms_upto(3000, ANY, state, &m1, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &b, NULL);
+      
+      str = zz_get_str(a);
+      len = strlen(str);
+      
+      f = tmpfile();
+      fprintf(f, "  %s,x", str);
+      rewind(f);
+      
+      n = zz_inp_str(b, f);
+
+      result = (n == len + 2 && zz_equal(a, b) && getc(f) == ',');
+
+      if (!result) 
+      {
+         printf("n = %lu, len = %lu\n", n, len);
+         zz_print_debug(a); zz_print_debug(b);
+      }
+
+      fclose(f);
+      free(str);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_import_export(void)
+{
+   int result = 1;
+   zz_t a, b;
+   len_t m1;
+   size_t count, size, i;
+   int order, endian;
+   unsigned char * buf;
+   char * str, * hex;
+   static const size_t sizes[] = { 1, 2, 3, 4, 5, 8, sizeof(word_t) };
+   
+   printf("zz_import/export...");
+
+   TEST_START(1, ITER) /* test import inverts export */
+   {
+      randoms_upto(30, ANY, state, &m1, NULL);
+      
+      size = sizes[randint(7, state)];
+      order = randint(2, state) ? 1 : -1;
+      endian = (int) randint(3, state) - 1;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &b, NULL);
+      
+      buf = (unsigned char *) zz_export(NULL, &count, order, size, endian, a);
+      zz_import(b, count, order, size, endian, buf);
+
+      if (a->size < 0)
+         zz_neg(b, b);
+
+      result = (zz_equal(a, b) && 8*count*size < zz_sizeinbase(a, 2) + 8*size
+                               && (a->size == 0) == (count == 0));
+
+      if (!result) 
+      {
+         printf("count = %lu, size = %lu, order = %d, endian = %d\n", 
+                                                count, size, order, endian);
+         zz_print_debug(a); zz_print_debug(b);
+      }
+
+      free(buf);
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test big endian bytes agree with hex string */
+   {
+      randoms_upto(30, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(m1, NONZERO, state, &a, NULL);
+      
+      buf = (unsigned char *) zz_export(NULL, &count, 1, 1, 1, a);
+      hex = (char *) malloc(2*count + 1);
+
+      for (i = 0; i < count; i++)
+         sprintf(hex + 2*i, "%02x", buf[i]);
+
+      str = zz_get_str_base(a, 16);
+      
+      result = (strcmp(hex + (hex[0] == '0'), str + (str[0] == '-')) == 0);
+
+      if (!result) 
+      {
+         printf("%s\n%s\n", hex, str);
+         zz_print_debug(a);
+      }
+
+      free(buf);
+      free(hex);
+      free(str);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_get_str_threaded(void)
+{
+   int result = 1;
+   zz_t a;
+   len_t m1;
+   long threads;
+   char * str1, * str2;
+   
+   printf("zz_get_str_threaded...");
+
+   TEST_START(1, ITER/100) /* test threaded conversion agrees */
+   {
+      randoms_upto(2000, ANY, state, &m1, NULL);
+      threads = randint(8, state) + 1;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      
+      str1 = zz_get_str(a);
+      str2 = zz_get_str_threaded(a, threads);
+
+      result = (strcmp(str1, str2) == 0);
+
+      if (!result) 
+      {
+         printf("threads = %ld\n%s\n%s\n", threads, str1, str2);
+         zz_print_debug(a);
+      }
+
+      free(str1);
+      free(str2);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_powm(void)
+{
+   int result = 1;
+   zz_t a, e, m, r1, r2, t, q;
+   len_t m1, m2;
+   sword_t i, w;
+   
+   printf("zz_powm...");
+
+   TEST_START(1, ITER/10) /* test against repeated multiplication */
+   {
+      randoms_upto(20, ANY, state, &m1, NULL);
+      randoms_upto(20, NONZERO, state, &m2, NULL);
+      w = (sword_t) randint(50, state);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(m2, NONZERO, state, &m, NULL);
+      randoms_signed(0, ANY, state, &e, &r1, &r2, &t, &q, NULL);
+      
+      zz_set(t, m); /* t = |m| */
+      if (t->size < 0)
+         zz_neg(t, t);
+
+      zz_seti(e, w);
+      result = zz_powm(r1, a, e, m);
+
+      zz_seti(r2, 1);
+      for (i = 0; i < w; i++)
+         zz_mul(r2, r2, a);
+      zz_divrem(q, r2, r2, t);
+      if (r2->size < 0)
+         zz_add(r2, r2, t);
+
+      result &= zz_equal(r1, r2);
+
+      if (!result) 
+      {
+         bsdnt_printf("w = %w\n", w);
+         zz_print_debug(a); zz_print_debug(m);
+         zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER/10) /* test a^(-e) * a^e = 1 */
+   {
+      randoms_upto(20, ANY, state, &m1, NULL);
+      randoms_upto(20, NONZERO, state, &m2, NULL);
+
+      randoms_signed(m1, ANY, state, &a, &e, NULL);
+      randoms_signed(m2, NONZERO, state, &m, NULL);
+      randoms_signed(0, ANY, state, &r1, &r2, &t, &q, NULL);
+      
+      zz_set(t, m); /* t = |m| */
+      if (t->size < 0)
+         zz_neg(t, t);
+
+      if (e->size > 0)
+         zz_neg(e, e);
+
+      result = zz_powm(r1, a, e, m);
+      zz_neg(e, e);
+      zz_powm(r2, a, e, m);
+
+      if (result)
+      {
+         zz_mul(r1, r1, r2);
+         zz_divrem(q, r1, r1, t);
+         if (r1->size < 0)
+            zz_add(r1, r1, t);
+         
+         zz_seti(r2, 1);
+         zz_divrem(q, r2, r2, t);
+         
+         result = zz_equal(r1, r2);
+      } else /* negative powers require a to be invertible */
+         result = (e->size != 0 && !zz_invert(r1, a, m));
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(e); zz_print_debug(m);
+         zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_powm_sec(void)
+{
+   int result = 1;
+   zz_t a, e, m, r1, r2;
+   len_t m1, m2, m3;
+   
+   printf("zz_powm_sec...");
+
+   TEST_START(1, ITER/10) /* test powm_sec agrees with powm */
+   {
+      randoms_upto(20, ANY, state, &m1, &m3, NULL);
+      randoms_upto(20, NONZERO, state, &m2, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(m2, ODD, state, &m, NULL);
+      randoms_signed(m3, ANY, state, &e, NULL);
+      randoms_signed(0, ANY, state, &r1, &r2, NULL);
+      
+      if (zz_is_zero(m))
+         zz_seti(m, 1);
+      if (e->size < 0)
+         zz_neg(e, e);
+
+      zz_powm(r1, a, e, m);
+      zz_powm_sec(r2, a, e, m);
+
+      result = zz_equal(r1, r2);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(e); zz_print_debug(m);
+         zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_powm_fixed(void)
+{
+   int result = 1;
+   zz_t a, e, m, r1, r2;
+   zz_powm_fixed_ctx_t ctx;
+   len_t m1, m2, m3;
+   word_t ebits, budget;
+   
+   printf("zz_powm_fixed...");
+
+   TEST_START(1, ITER/10) /* test powm_fixed agrees with powm */
+   {
+      randoms_upto(20, ANY, state, &m1, NULL);
+      randoms_upto(20, NONZERO, state, &m2, &m3, NULL);
+      randoms_upto(m3*WORD_BITS + 2, NONZERO, state, &ebits, NULL);
+      randoms_upto(65536, ANY, state, &budget, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(m2, ODD, state, &m, NULL);
+      randoms_signed(m3, POSITIVE, state, &e, NULL);
+      randoms_signed(0, ANY, state, &r1, &r2, NULL);
+      
+      if (zz_is_zero(m))
+         zz_seti(m, 1);
+
+      zz_powm_fixed_ctx_init(ctx, a, m, ebits, budget);
+      
+      zz_powm(r1, a, e, m);
+      zz_powm_fixed(r2, e, ctx);
+
+      /* check also that no block of the exponent is empty */
+      result = (zz_equal(r1, r2) && (ctx->v - 1)*ctx->b < ctx->a);
+
+      if (!result) 
+      {
+         bsdnt_printf("%w %w\n", ebits, budget);
+         zz_print_debug(a); zz_print_debug(e); zz_print_debug(m);
+         zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      zz_powm_fixed_ctx_clear(ctx);
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_multi_powm(void)
+{
+   int result = 1;
+   zz_t m, r1, r2, t, q;
+   zz_struct g[100], e[100];
+   zz_srcptr gp[100], ep[100];
+   len_t m1, m2, m3, num, i;
+   
+   printf("zz_multi_powm...");
+
+   TEST_START(1, ITER/10) /* test multi_powm agrees with powm */
+   {
+      randoms_upto(100, ANY, state, &num, NULL);
+      randoms_upto(10, ANY, state, &m1, &m3, NULL);
+      randoms_upto(10, NONZERO, state, &m2, NULL);
+
+      randoms_signed(m2, ANY, state, &m, NULL);
+      randoms_signed(0, ANY, state, &r1, &r2, &t, &q, NULL);
+      
+      if (zz_is_zero(m))
+         zz_seti(m, 1);
+
+      zz_set(q, m);
+      if (q->size < 0)
+         zz_neg(q, q);
+
+      zz_seti(r1, 1);
+      zz_divrem(t, r1, r1, q);
+
+      for (i = 0; i < num; i++)
+      {
+         zz_init(g + i);
+         zz_init(e + i);
+         zz_random(g + i, state, m1);
+         zz_random(e + i, state, m3);
+         if (e[i].size < 0)
+            zz_neg(e + i, e + i);
+         gp[i] = g + i;
+         ep[i] = e + i;
+
+         zz_powm(t, g + i, e + i, m);
+         zz_mul(r1, r1, t);
+         zz_divrem(t, r1, r1, q);
+      }
+
+      zz_multi_powm(r2, gp, ep, num, m);
+
+      result = zz_equal(r1, r2);
+
+      if (!result) 
+      {
+         bsdnt_printf("%w\n", num);
+         zz_print_debug(m); zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      for (i = 0; i < num; i++)
+      {
+         zz_clear(g + i);
+         zz_clear(e + i);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_mod_mersenne(void)
+{
+   int result = 1;
+   zz_t a, q, r1, r2, m;
+   len_t m1;
+   bits_t p;
+   
+   printf("zz_mod_mersenne...");
+
+   TEST_START(1, ITER) /* test mod_mersenne agrees with divrem */
+   {
+      randoms_upto(20, ANY, state, &m1, NULL);
+      randoms_upto(400, NONZERO, state, &p, NULL);
+      p++;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &q, &r1, &r2, &m, NULL);
+      
+      zz_seti(m, 1);
+      zz_mul_2exp(m, m, p);
+      zz_subi(m, m, 1);
+
+      zz_divrem(q, r1, a, m);
+      if (r1->size < 0)
+         zz_add(r1, r1, m);
+
+      zz_mod_mersenne(r2, a, p);
+
+      result = zz_equal(r1, r2);
+
+      if (!result) 
+      {
+         bsdnt_printf("p = %b\n", p);
+         zz_print_debug(a); zz_print_debug(r1); zz_print_debug(r2);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_sqrtrem(void)
+{
+   int result = 1;
+   zz_t a, s, r, t;
+   len_t m1;
+   
+   printf("zz_sqrtrem...");
+
+   TEST_START(1, ITER) /* test s^2 + r = a and (s + 1)^2 > a */
+   {
+      randoms_upto(40, NONZERO, state, &m1, NULL);
+
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &s, &r, &t, NULL);
+      
+      zz_sqrtrem(s, r, a);
+
+      zz_mul(t, s, s);
+      zz_add(t, t, r);
+      result = (zz_equal(t, a) && r->size >= 0);
+
+      zz_addi(t, s, 1);
+      zz_mul(t, t, t);
+      result &= (zz_cmp(t, a) > 0);
+
+      zz_sqrt(t, a);
+      result &= zz_equal(t, s);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(s); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test aliasing */
+   {
+      randoms_upto(40, NONZERO, state, &m1, NULL);
+
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &s, &r, NULL);
+      
+      zz_sqrt(s, a);
+      zz_sqrt(a, a);
+
+      result = zz_equal(a, s);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(s);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_pow(void)
+{
+   int result = 1;
+   zz_t a, r, t;
+   len_t m1;
+   word_t k, i;
+   
+   printf("zz_pow...");
+
+   TEST_START(1, ITER) /* test pow agrees with repeated multiplication */
+   {
+      randoms_upto(10, ANY, state, &m1, NULL);
+      randoms_upto(40, ANY, state, &k, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, &t, NULL);
+      
+      zz_seti(t, 1);
+      for (i = 0; i < k; i++)
+         zz_mul(t, t, a);
+
+      zz_pow(r, a, k);
+      zz_pow(a, a, k);
+
+      result = (zz_equal(r, t) && zz_equal(a, t));
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %w\n", k);
+         zz_print_debug(t); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_rootrem(void)
+{
+   int result = 1;
+   zz_t a, r, rem, t, u;
+   len_t m1;
+   word_t k;
+   
+   printf("zz_rootrem...");
+
+   TEST_START(1, ITER) /* test r^k + rem = a and (|r| + 1)^k > |a| */
+   {
+      randoms_upto(60, NONZERO, state, &m1, NULL);
+      randoms_upto(30, NONZERO, state, &k, NULL);
+      if (k > 20)
+         k = randint(1000, state) + 1;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, &rem, &t, &u, NULL);
+      
+      if ((k & 1) == 0 && a->size < 0)
+         zz_neg(a, a);
+
+      zz_rootrem(r, rem, a, k);
+
+      zz_pow(t, r, k);
+      zz_add(t, t, rem);
+      result = zz_equal(t, a);
+
+      /* rem has the sign of a */
+      result &= (rem->size == 0 || (rem->size ^ a->size) >= 0);
+      
+      zz_set(u, r);
+      if (u->size < 0)
+         zz_neg(u, u);
+      zz_addi(u, u, 1);
+      zz_pow(t, u, k);
+      result &= (zz_cmpabs(t, a) > 0);
+
+      zz_root(t, a, k);
+      result &= zz_equal(t, r);
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %w\n", k);
+         zz_print_debug(a); zz_print_debug(r); zz_print_debug(rem);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test roots of perfect powers */
+   {
+      randoms_upto(20, NONZERO, state, &m1, NULL);
+      randoms_upto(12, NONZERO, state, &k, NULL);
+
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, &rem, &t, NULL);
+      
+      zz_pow(t, a, k);
+      zz_rootrem(r, rem, t, k);
+
+      result = (zz_equal(r, a) && zz_is_zero(rem));
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %w\n", k);
+         zz_print_debug(a); zz_print_debug(r); zz_print_debug(rem);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_is_square(void)
+{
+   int result = 1;
+   zz_t a, s, r, t;
+   len_t m1;
+   word_t w;
+   
+   printf("zz_is_square...");
+
+   TEST_START(1, ITER) /* test squares and their neighbours */
+   {
+      randoms_upto(30, NONZERO, state, &m1, NULL);
+
+      randoms_signed(m1, NONZERO, state, &a, NULL);
+      randoms_signed(0, ANY, state, &t, NULL);
+      
+      zz_mul(t, a, a);
+      result = zz_is_square(t);
+
+      zz_addi(t, t, 1);
+      result &= !zz_is_square(t);
+
+      zz_subi(t, t, 2);
+      result &= (zz_is_square(t) == zz_equali(t, 0));
+
+      zz_addi(t, t, 1);
+      zz_neg(t, t);
+      result &= !zz_is_square(t);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(t);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test against zz_sqrtrem */
+   {
+      randoms_upto(30, ANY, state, &m1, NULL);
+      randoms_upto(64, ANY, state, &w, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &s, &r, NULL);
+
+      if (m1 == 0) /* small values */
+         zz_seti(a, (sword_t) w);
+      
+      if (a->size < 0)
+         zz_neg(a, a);
+
+      zz_sqrtrem(s, r, a);
+      result = (zz_is_square(a) == zz_is_zero(r));
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_is_perfect_power(void)
+{
+   int result = 1;
+   zz_t a, y, r, t;
+   len_t m1;
+   word_t k, j, p;
+   bits_t bits;
+   
+   printf("zz_is_perfect_power...");
+
+   TEST_START(1, ITER/5) /* test r^(j/k) = y for a = y^k = r^j */
+   {
+      randoms_upto(10, NONZERO, state, &m1, NULL);
+      randoms_upto(20, NONZERO, state, &k, NULL);
+      if (k == 1)
+         k = randint(200, state) + 2;
+
+      randoms_signed(m1, NONZERO, state, &y, NULL);
+      randoms_signed(0, ANY, state, &a, &r, &t, NULL);
+      
+      if (BSDNT_ABS(y->size) == 1) /* ensure |y| >= 2 */
+         y->n[0] |= 2;
+
+      zz_pow(a, y, k);
+      if ((k & 1) == 0 && y->size < 0)
+         zz_neg(y, y);
+      
+      j = zz_is_perfect_power(r, a);
+      
+      result = (j != 0 && j % k == 0);
+      if (result)
+      {
+         zz_pow(t, r, j/k);
+         result = zz_equal(t, y);
+      }
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %w, j = %w\n", k, j);
+         zz_print_debug(y); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER) /* test powers of small values */
+   {
+      randoms_upto(100, NONZERO, state, &j, NULL);
+      randoms_upto(30, NONZERO, state, &k, NULL);
+      
+      randoms_signed(0, ANY, state, &a, &y, &r, &t, NULL);
+      
+      zz_seti(y, (sword_t) j + 1);
+      if ((k & 1) && randint(2, state))
+         zz_neg(y, y);
+
+      zz_pow(a, y, k);
+      j = zz_is_perfect_power(r, a);
+      
+      result = (j == 0 ? k == 1 : j % k == 0);
+      if (j != 0 && result)
+      {
+         zz_pow(t, r, j);
+         result = zz_equal(t, a);
+      }
+
+      if (!result) 
+      {
+         bsdnt_printf("k = %w, j = %w\n", k, j);
+         zz_print_debug(y); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(3, ITER/10) /* test random values against zz_rootrem */
+   {
+      randoms_upto(3, ANY, state, &m1, NULL);
+      randoms_upto(64, ANY, state, &j, NULL);
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &y, &r, &t, NULL);
+      
+      if (m1 == 0) /* small values */
+         zz_seti(a, (sword_t) j - 32);
+
+      k = zz_is_perfect_power(r, a);
+      
+      if (k != 0)
+      {
+         zz_pow(t, r, k);
+         result = (k > 1 && zz_equal(t, a));
+      } else /* no root of prime degree is exact */
+      {
+         bits = zz_sizeinbase(a, 2);
+         for (p = 2; result && (bits_t) p < bits; p++)
+         {
+            if ((p & 1) == 0 && (p != 2 || a->size < 0))
+               continue;
+            zz_rootrem(y, t, a, p);
+            result = !zz_is_zero(t);
+         }
+      }
+      
+      if (!result) 
+      {
+         bsdnt_printf("k = %w\n", k);
+         zz_print_debug(a); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_is_probab_prime(void)
+{
+   int result = 1;
+   zz_t a, b, e, r;
+   len_t m1, m2;
+   word_t w, d;
+   long i;
+   int p;
+   /* strong pseudoprimes to base 2 and strong Lucas pseudoprimes */
+   const word_t psp[] = { 2047, 3277, 4033, 4681, 8321, 15841, 29341, 
+                          5459, 5777, 10877, 16109, 18971, 22499 };
+   const bits_t mp[] = { 89, 107, 127, 521, 607, 1279 };
+   const bits_t mc[] = { 67, 101, 103, 109, 137, 257 };
+   
+   printf("zz_is_probab_prime...");
+
+   TEST_START(1, ITER) /* test small values by trial division */
+   {
+      randoms_upto(1 << 20, ANY, state, &w, NULL);
+      
+      randoms_signed(0, ANY, state, &a, NULL);
+      
+      zz_seti(a, (sword_t) w);
+      
+      p = (w >= 2);
+      for (d = 2; d*d <= w && p; d++)
+         p = (w % d != 0);
+
+      result = (zz_is_probab_prime(a) == 2*p && n_is_prime(w) == p);
+
+      if (!result) 
+         bsdnt_printf("w = %w\n", w);
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, 1) /* test known composites and Mersenne numbers */
+   {
+      randoms_signed(0, ANY, state, &a, NULL);
+      
+      for (w = 0; w < 4 && result; w++)
+         result = (n_is_prime(w) == (w >= 2));
+
+      for (i = 0; i < 13 && result; i++)
+      {
+         zz_seti(a, (sword_t) psp[i]);
+         result = (zz_is_probab_prime(a) == 0);
+      }
+
+      for (i = 0; i < 6 && result; i++)
+      {
+         zz_seti(a, 1);
+         zz_mul_2exp(a, a, mp[i]);
+         zz_subi(a, a, 1);
+         result = (zz_is_probab_prime(a) == 1 + (mp[i] < WORD_BITS));
+
+         zz_seti(a, 1);
+         zz_mul_2exp(a, a, mc[i]);
+         zz_subi(a, a, 1);
+         result &= (zz_is_probab_prime(a) == 0);
+      }
+
+      if (!result) 
+         printf("i = %ld\n", i - 1);
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(3, ITER/10) /* test products are composite */
+   {
+      randoms_upto(10, NONZERO, state, &m1, &m2, NULL);
+      
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(m2, POSITIVE, state, &b, NULL);
+      randoms_signed(0, ANY, state, &r, NULL);
+      
+      zz_addi(a, a, 1);
+      zz_addi(b, b, 1);
+      zz_mul(r, a, b);
+
+      result = (zz_is_probab_prime(r) == 0);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(b);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(4, ITER/10) /* test probable primes are Fermat probable primes */
+   {
+      randoms_upto(6, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &b, &e, &r, NULL);
+      
+      a->n[0] |= 1;
+      
+      p = zz_is_probab_prime(a);
+      if (p != 0 && !zz_equali(a, 3))
+      {
+         zz_subi(e, a, 1);
+         zz_seti(b, 3);
+         zz_powm(r, b, e, a);
+         result = zz_equali(r, 1);
+      }
+
+      if (!result) 
+      {
+         zz_print_debug(a);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_nextprime(void)
+{
+   int result = 1;
+   zz_t a, r, t;
+   len_t m1;
+   word_t w, d, q;
+   int p;
+   
+   printf("zz_nextprime...");
+
+   TEST_START(1, ITER) /* test small values by trial division */
+   {
+      randoms_upto(1 << 20, ANY, state, &w, NULL);
+      
+      randoms_signed(0, ANY, state, &a, &r, NULL);
+      
+      zz_seti(a, (sword_t) w);
+      zz_nextprime(r, a);
+
+      /* the least prime above w */
+      for (q = w + 1, p = 0; !p; q++)
+      {
+         p = (q >= 2);
+         for (d = 2; d*d <= q && p; d++)
+            p = (q % d != 0);
+      }
+
+      result = zz_equali(r, (sword_t) q - 1);
+
+      if (!result) 
+         bsdnt_printf("w = %w\n", w);
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(2, ITER/100) /* test there is no probable prime in between */
+   {
+      randoms_upto(6, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, &t, NULL);
+      
+      zz_nextprime(r, a);
+      result = (zz_cmp(r, a) > 0 && zz_is_probab_prime(r));
+
+      for (zz_addi(t, a, 1); result && zz_cmp(t, r) < 0; zz_addi(t, t, 1))
+         result = !zz_is_probab_prime(t);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   TEST_START(aliasing, ITER/10) 
+   {
+      randoms_upto(4, NONZERO, state, &m1, NULL);
+      
+      randoms_signed(m1, POSITIVE, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, NULL);
+      
+      zz_nextprime(r, a);
+      zz_nextprime(a, a);
+      
+      result = zz_equal(r, a);
+
+      if (!result) 
+      {
+         zz_print_debug(a); zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_sieve(void)
+{
+   int result = 1;
+   zz_t a, r, t;
+   zz_sieve_t S;
+   len_t m1;
+   word_t bound;
+   long i;
+   
+   printf("zz_sieve...");
+
+   TEST_START(1, ITER/20) /* test successive primes agree with zz_nextprime */
+   {
+      randoms_upto(4, ANY, state, &m1, NULL);
+      randoms_upto(2000, ANY, state, &bound, NULL);
+      
+      /* bound + 1 is a multiple of the bits in two words */
+      if (randint(4, state) == 0)
+         bound = 2*WORD_BITS - 1;
+
+      randoms_signed(m1, ANY, state, &a, NULL);
+      randoms_signed(0, ANY, state, &r, &t, NULL);
+      
+      if (a->size < 0)
+         zz_neg(a, a);
+
+      /* the least prime >= a */
+      zz_subi(t, a, 1);
+      zz_nextprime(t, t);
+      if (zz_equali(t, 2)) /* the sieve only has odd values */
+         zz_nextprime(t, t);
+
+      zz_sieve_init(S, a, bound);
+      
+      for (i = 0; i < 20 && result; i++)
+      {
+         zz_sieve_next(r, S);
+         result = zz_equal(r, t);
+         zz_nextprime(t, t);
+      }
+
+      zz_sieve_clear(S);
+
+      if (!result) 
+      {
+         bsdnt_printf("bound = %w\n", bound);
+         zz_print_debug(a); zz_print_debug(r); zz_print_debug(t);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
+int test_random_prime(void)
+{
+   int result = 1;
+   zz_t r;
+   word_t bits;
+   
+   printf("zz_random_prime...");
+
+   TEST_START(1, ITER/100) 
+   {
+      randoms_upto(300, ANY, state, &bits, NULL);
+      
+      randoms_signed(0, ANY, state, &r, NULL);
+      
+      bits += 2;
+      zz_random_prime(r, bits, state);
+
+      result = (zz_sizeinbase(r, 2) == bits && zz_is_probab_prime(r));
+
+      if (!result) 
+      {
+         bsdnt_printf("bits = %w\n", bits);
+         zz_print_debug(r);
+      }
+
+      gc_cleanup();
+   } TEST_END;
+
+   return result;
+}
+
 int test_zz(void)
 {
    long pass = 0;
@@ -1561,7 +3109,30 @@ int test_zz(void)
    RUN(test_div);
    RUN(test_gcd);
    RUN(test_xgcd);
+   RUN(test_invert);
+   RUN(test_powm);
+   RUN(test_powm_sec);
+   RUN(test_powm_fixed);
+   RUN(test_multi_powm);
+   RUN(test_mod_mersenne);
+   RUN(test_sqrtrem);
+   RUN(test_pow);
+   RUN(test_rootrem);
+   RUN(test_is_square);
+   RUN(test_is_perfect_power);
+   RUN(test_is_probab_prime);
+   RUN(test_nextprime);
+   RUN(test_sieve);
+   RUN(test_random_prime);
+   RUN(test_batch_gcd);
+   RUN(test_crt);
    RUN(test_get_set_str);
+   RUN(test_get_set_str_base);
+   RUN(test_get_str_threaded);
+   RUN(test_out_str);
+   RUN(test_set_strn);
+   RUN(test_inp_str);
+   RUN(test_import_export);
    
    printf("%ld of %ld tests pass.\n", pass, pass + fail);
 
@@ -28,8 +28,12 @@
 #ifndef TUNING_H
 #define TUNING_H
 
+#define MUL_FIXED_CUTOFF 16L /* largest length using nn_fixed kernels */
+
 #define MUL_CLASSICAL_CUTOFF 33L
 
+#define SQR_CLASSICAL_CUTOFF 160L
+
 #define MUL_KARA_CUTOFF 400L
 
 #define MUL_TOOM32_CUTOFF LONG_MAX /* no fft yet */
@@ -44,5 +48,15 @@
 
 #define DIVREM_CLASSICAL_CUTOFF 80L
 
+#define MULTI_MOD_CUTOFF 32L
+
+#define MULMOD_2EXPP1_KARA_CUTOFF 8L
+
+#define GET_STR_DIVCONQUER_CUTOFF 40L
+
+#define SET_STR_DIVCONQUER_CUTOFF 500L
+
+#define INP_STR_BLOCK_DIGITS (DEC_WORD_DIGITS*1024L)
+
 #endif
 
@@ -0,0 +1,13 @@
+
+
+
+
+
+
+
+
+
+
+
+
+
@@ -25,6 +25,8 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <ctype.h>
+#include <math.h>
 #include "zz.h"
 
 void zz_init(zz_ptr r)
@@ -480,7 +482,10 @@ void zz_mul(zz_ptr r, zz_srcptr a, zz_srcptr b)
 
       ZZ_ORDER(a, asize, b, bsize);
 
-      nn_mul(t->n, a->n, asize, b->n, bsize);
+      if (a == b)
+         nn_sqr(t->n, a->n, asize);
+      else
+         nn_mul(t->n, a->n, asize, b->n, bsize);
       rsize -= (t->n[rsize - 1] == 0);
 
       t->size = (a->size ^ b->size) < 0 ? -rsize : rsize;
@@ -719,66 +724,2359 @@ void zz_xgcd(zz_ptr g, zz_ptr s, zz_ptr t, zz_srcptr a, zz_srcptr b)
    }
 }
 
-char * zz_get_str(zz_srcptr a)
+int zz_invert(zz_ptr r, zz_srcptr a, zz_srcptr m)
 {
-   len_t size = BSDNT_ABS(a->size);
-   char * str;
-   size_t i;
-   nn_t t;
+   len_t asize = BSDNT_ABS(a->size);
+   len_t msize = BSDNT_ABS(m->size);
+   len_t size;
+   nn_t t, q, d;
+   int ret;
    TMP_INIT;
-   
+
+   if (msize == 0)
+      return 0;
+
    TMP_START;
-   
-   t = (nn_t) TMP_ALLOC(size);
-  
-   nn_copy(t, a->n, size);
 
-   str = nn_get_str(t, size);
+   t = (nn_t) TMP_ALLOC(BSDNT_MAX(asize, msize));
+   d = (nn_t) TMP_ALLOC(msize);
 
-   if (a->size < 0)
+   nn_copy(t, a->n, asize);
+   nn_copy(d, m->n, msize);
+
+   if (asize >= msize) /* reduce a mod m */
    {
-      size_t len = strlen(str);
-      str = (char *) realloc(str, len + 2);
-      for (i = len + 1; i >= 1; i--)
-         str[i] = str[i - 1];
-      str[0] = '-';
+      q = (nn_t) TMP_ALLOC(asize - msize + 1);
+      nn_divrem(q, t, asize, d, msize);
+      asize = msize;
+   }
+   
+   size = nn_normalise(t, asize);
+   
+   if (a->size < 0 && size != 0) /* make residue nonnegative */
+   {
+      nn_sub(t, d, msize, t, size);
+      size = nn_normalise(t, msize);
    }
 
+   zz_fit(r, msize);
+
+   if ((ret = nn_invmod(r->n, t, size, d, msize)))
+      r->size = nn_normalise(r->n, msize);
+
    TMP_END;
 
-   return str;
+   return ret;
 }
 
-size_t zz_set_str(zz_t a, const char * str)
+void zz_pow(zz_ptr r, zz_srcptr a, word_t k)
 {
-   int sgn = 0;
+   zz_t t;
+   int i;
+
+   if (k == 0)
+   {
+      zz_seti(r, 1);
+      return;
+   }
+
+   zz_init(t);
+   zz_seti(t, 1);
+
+   for (i = WORD_BITS - 1 - high_zero_bits(k); i >= 0; i--)
+   {
+      zz_mul(t, t, t);
+      if ((k >> i) & 1)
+         zz_mul(t, t, a);
+   }
+
+   zz_swap(r, t);
+   zz_clear(t);
+}
+
+int zz_powm(zz_ptr r, zz_srcptr a, zz_srcptr e, zz_srcptr m)
+{
+   len_t msize = BSDNT_ABS(m->size);
    len_t size;
-   size_t digits;
+   zz_t t, b;
+   int neg = 0;
+
+   ASSERT(msize != 0);
+
+   zz_init(b);
+
+   if (e->size < 0)
+   {
+      if (!zz_invert(b, a, m))
+      {
+         zz_clear(b);
+         return 0;
+      }
+   } else
+   {
+      zz_set(b, a);
+      neg = (a->size < 0 && e->size != 0 && (e->n[0] & 1));
+   }
+
+   zz_init_fit(t, msize);
+
+   nn_powm(t->n, b->n, BSDNT_ABS(b->size), e->n, BSDNT_ABS(e->size), 
+                                                            m->n, msize);
+   size = nn_normalise(t->n, msize);
+
+   if (neg && size != 0) /* (-a)^e = -(a^e) for odd e */
+   {
+      nn_sub_m(t->n, m->n, t->n, msize);
+      size = nn_normalise(t->n, msize);
+   }
+
+   t->size = size;
+
+   zz_swap(r, t);
+   zz_clear(t);
+   zz_clear(b);
+
+   return 1;
+}
+
+void zz_powm_sec(zz_ptr r, zz_srcptr a, zz_srcptr e, zz_srcptr m)
+{
+   len_t msize = BSDNT_ABS(m->size);
+   zz_t t, b, q, d;
+
+   ASSERT(msize != 0 && (m->n[0] & 1));
+   ASSERT(e->size >= 0);
+
+   zz_init(b);
+
+   if (a->size < 0) /* reduce a into [0, |m|) */
+   {
+      zz_init(q);
+      zz_init(d);
+      zz_set(d, m);
+      if (d->size < 0)
+         zz_neg(d, d);
+      
+      zz_divrem(q, b, a, d);
+      if (b->size < 0)
+         zz_add(b, b, d);
+      
+      zz_clear(d);
+      zz_clear(q);
+   } else
+      zz_set(b, a);
+
+   zz_init_fit(t, msize);
+
+   nn_powm_sec(t->n, b->n, b->size, e->n, e->size, m->n, msize);
+   t->size = nn_normalise(t->n, msize);
+
+   zz_swap(r, t);
+   zz_clear(t);
+   zz_clear(b);
+}
+
+void zz_mod_mersenne(zz_ptr r, zz_srcptr a, bits_t p)
+{
+   const len_t n = (p + WORD_BITS - 1)/WORD_BITS;
+   len_t i, size = BSDNT_ABS(a->size);
+   zz_t t;
+
+   ASSERT(p > 1);
+
+   if (size == 0)
+   {
+      zz_zero(r);
+      return;
+   }
+
+   zz_init_fit(t, n);
+
+   nn_mod_2exp_minus_c(t->n, a->n, size, p, 1);
+   t->size = nn_normalise(t->n, n);
    
-   if (str[0] == '-') 
+   /* 2^p - 1 - t is the complement of t in the low p bits */
+   if (a->size < 0 && t->size != 0)
    {
-      sgn = 1;
-      str++;
+      for (i = 0; i < n; i++)
+         t->n[i] = ~t->n[i];
+      if ((p % WORD_BITS) != 0)
+         t->n[n - 1] &= (WORD(1) << (p % WORD_BITS)) - 1;
+      t->size = nn_normalise(t->n, n);
    }
 
-   digits = strspn(str, "0123456789");
+   zz_swap(r, t);
+   zz_clear(t);
+}
+
+void zz_powm_fixed_ctx_init(zz_powm_fixed_ctx_t ctx, zz_srcptr g, 
+                             zz_srcptr m, bits_t ebits, size_t budget)
+{
+   const len_t n = BSDNT_ABS(m->size);
+   size_t words;
+   double cost, best = -1.0;
+   len_t a, b, v, k, t, x;
+   word_t w = 1;
+   nn_t p, one, tab;
+   int h;
+   zz_t q;
+   TMP_INIT;
+
+   ASSERT(n != 0 && (m->n[0] & 1));
+
+   ebits = BSDNT_MAX(ebits, 1);
+   if (budget == 0)
+      budget = ZZ_POWM_FIXED_BUDGET;
    
-   /* 0.0519... is log_{2^64}(10) */
-   size = (len_t) ceil(0.0519051265 * digits * (64/WORD_BITS));
-   zz_fit(a, size);
+   /* table entries allowed by the budget */
+   words = budget/(n*sizeof(word_t));
+
+   /* h = 1, v = 1 is always allowed */
+   ctx->h = 1;
+   ctx->a = ctx->b = ebits;
+   ctx->v = 1;
+
+   /* 
+      for each h take the most blocks that fit, which minimises the 
+      squarings, and count b - 1 squarings and about a products
+   */
+   for (h = 1; h <= 16 && h <= ebits && (WORD(1) << h) <= words; h++)
+   {
+      a = (ebits + h - 1)/h;
+      v = BSDNT_MIN(a, (len_t) (words >> h));
+      b = (a + v - 1)/v;
+      v = (a + b - 1)/b; /* so that no block is empty */
+      cost = (b - 1) + a*(1.0 - 1.0/(double) (WORD(1) << h));
 
-   digits = nn_set_str(a->n, &size, str);
+      if (best < 0 || cost < best)
+      {
+         best = cost;
+         ctx->h = h;
+         ctx->a = a;
+         ctx->b = b;
+         ctx->v = v;
+      }
+   }
 
-   a->size = sgn ? -size : size;
+   zz_init(&ctx->m);
+   zz_set(&ctx->m, m);
+   ctx->ebits = ebits;
+   precompute_hensel_inverse1(&ctx->dinv, m->n[0]);
+
+   /* g reduced into [0, |m|) */
+   zz_init(&ctx->g);
+   zz_init(q);
+   if (m->size < 0)
+      zz_neg(&ctx->m, &ctx->m);
+   zz_divrem(q, &ctx->g, g, &ctx->m);
+   if (ctx->g.size < 0)
+      zz_add(&ctx->g, &ctx->g, &ctx->m);
+   zz_set(&ctx->m, m);
+   zz_clear(q);
+
+   h = ctx->h;
+   a = ctx->a;
+   b = ctx->b;
+   v = ctx->v;
+   
+   ctx->tab = tab = (nn_t) malloc(((v*n) << h)*sizeof(word_t));
+   
+   TMP_START;
 
-   return digits + sgn;
+   p = (nn_t) TMP_ALLOC(n);
+   one = (nn_t) TMP_ALLOC(n);
+
+   nn_mont_set(p, ctx->g.n, ctx->g.size, m->n, n);
+   nn_mont_set(one, &w, 1, m->n, n);
+
+   /* tab[k][2^j] = g^(2^(j*a + k*b)), with p = g^(2^t) */
+   for (t = 0; t <= (h - 1)*a + (v - 1)*b; t++)
+   {
+      if ((t % a) % b == 0 && (t % a)/b < v)
+         nn_copy(tab + (((t % a)/b << h) + (WORD(1) << (t/a)))*n, p, n);
+      
+      nn_mont_mul(p, p, p, m->n, n, ctx->dinv);
+   }
+
+   /* tab[k][x] for other x is a product of the entries for its bits */
+   for (k = 0; k < v; k++, tab += (n << h))
+   {
+      nn_copy(tab, one, n);
+
+      for (x = 3; x < (1L << h); x++)
+      {
+         if ((x & (x - 1)) != 0)
+            nn_mont_mul(tab + x*n, tab + (x & (x - 1))*n, 
+                                     tab + (x & -x)*n, m->n, n, ctx->dinv);
+      }
+   }
+
+   TMP_END;
 }
 
-void zz_print(zz_srcptr a)
+void zz_powm_fixed_ctx_clear(zz_powm_fixed_ctx_t ctx)
+{
+   free(ctx->tab);
+   zz_clear(&ctx->g);
+   zz_clear(&ctx->m);
+}
+
+void zz_powm_fixed(zz_ptr r, zz_srcptr e, zz_powm_fixed_ctx_t ctx)
+{
+   const len_t n = BSDNT_ABS(ctx->m.size);
+   const len_t a = ctx->a, b = ctx->b, v = ctx->v;
+   const int h = ctx->h;
+   bits_t ebits, pos;
+   len_t i, k, x;
+   int j;
+   zz_t t;
+
+   ASSERT(e->size >= 0);
+
+   ebits = e->size*WORD_BITS;
+   if (e->size != 0)
+      ebits -= high_zero_bits(e->n[e->size - 1]);
+
+   if (ebits > ctx->ebits)
+   {
+      zz_powm(r, &ctx->g, e, &ctx->m);
+      return;
+   }
+
+   zz_init_fit(t, n);
+   nn_copy(t->n, ctx->tab, n);
+
+   /* column i of each block, from the top, with no squaring first */
+   for (i = b - 1; i >= 0; i--)
+   {
+      if (i != b - 1)
+         nn_mont_mul(t->n, t->n, t->n, ctx->m.n, n, ctx->dinv);
+
+      for (k = v - 1; k >= 0; k--)
+      {
+         if (k*b + i >= a)
+            continue;
+
+         for (x = 0, j = h - 1; j >= 0; j--)
+         {
+            pos = j*a + k*b + i;
+            x = 2*x + (pos < ebits && nn_bit_test(e->n, pos));
+         }
+
+         if (x != 0)
+            nn_mont_mul(t->n, t->n, ctx->tab + ((k << h) + x)*n, 
+                                                ctx->m.n, n, ctx->dinv);
+      }
+   }
+
+   nn_mont_get(t->n, t->n, ctx->m.n, n, ctx->dinv);
+   t->size = nn_normalise(t->n, n);
+
+   zz_swap(r, t);
+   zz_clear(t);
+}
+
+/* 
+   Return bits [pos, pos + c) of e >= 0, where c < WORD_BITS.
+*/
+static
+word_t _zz_multi_powm_digit(zz_srcptr e, bits_t pos, int c)
+{
+   len_t i = pos/WORD_BITS;
+   int s = pos % WORD_BITS;
+   word_t x;
+
+   if (i >= e->size)
+      return 0;
+
+   x = e->n[i] >> s;
+   if (s + c > WORD_BITS && i + 1 < e->size)
+      x |= e->n[i + 1] << (WORD_BITS - s);
+
+   return x & ((WORD(1) << c) - 1);
+}
+
+/*
+   Straus: table[i][j - 1] = g_i^j for 0 < j < 2^w, then for each
+   window of w bits from the top, w shared squarings and one product
+   per nonzero digit. The scratch space s must have 2*n words.
+*/
+static
+void _zz_multi_powm_straus(nn_t t, nn_src_t x, zz_srcptr * e, 
+                size_t num, bits_t bits, int w, nn_src_t d, len_t n, 
+                                           hensel_preinv1_t dinv, nn_t s)
+{
+   const len_t tlen = (WORD(1) << w) - 1;
+   len_t j, k;
+   nn_t tab;
+   word_t digit;
+   size_t i;
+   int first = 1;
+   TMP_INIT;
+
+   TMP_START;
+   tab = (nn_t) TMP_ALLOC(num*tlen*n);
+
+   for (i = 0; i < num; i++)
+   {
+      nn_t p = tab + i*tlen*n;
+
+      nn_copy(p, x + i*n, n);
+      for (j = 1; j < tlen; j++)
+         nn_mont_mul_tmp(p + j*n, p + (j - 1)*n, p, d, n, dinv, s);
+   }
+
+   for (k = (bits + w - 1)/w - 1; k >= 0; k--)
+   {
+      if (!first)
+      {
+         for (j = 0; j < w; j++)
+            nn_mont_mul_tmp(t, t, t, d, n, dinv, s);
+      }
+
+      for (i = 0; i < num; i++)
+      {
+         digit = _zz_multi_powm_digit(e[i], k*w, w);
+
+         if (digit != 0)
+         {
+            if (first)
+               nn_copy(t, tab + (i*tlen + digit - 1)*n, n);
+            else
+               nn_mont_mul_tmp(t, t, tab + (i*tlen + digit - 1)*n, 
+                                                          d, n, dinv, s);
+            first = 0;
+         }
+      }
+   }
+
+   TMP_END;
+}
+
+/*
+   Pippenger: for each window of c bits from the top, c shared 
+   squarings, then bucket[j - 1] = product of the g_i with digit j and
+   prod_j bucket[j - 1]^j is formed with a running product from the 
+   top bucket down, for about num + 2^(c + 1) products per window. The
+   scratch space s must have 2*n words.
+*/
+static
+void _zz_multi_powm_pippenger(nn_t t, nn_src_t x, zz_srcptr * e, 
+                size_t num, bits_t bits, int c, nn_src_t d, len_t n, 
+                                           hensel_preinv1_t dinv, nn_t s)
+{
+   const len_t blen = (WORD(1) << c) - 1;
+   len_t j, k;
+   nn_t bucket, run;
+   char * used;
+   word_t digit;
+   size_t i;
+   int first = 1, started;
+   TMP_INIT;
+
+   TMP_START;
+   bucket = (nn_t) TMP_ALLOC((blen + 1)*n);
+   run = bucket + blen*n;
+   used = (char *) TMP_ALLOC_BYTES(blen);
+
+   for (k = (bits + c - 1)/c - 1; k >= 0; k--)
+   {
+      if (!first)
+      {
+         for (j = 0; j < c; j++)
+            nn_mont_mul_tmp(t, t, t, d, n, dinv, s);
+      }
+
+      memset(used, 0, blen);
+
+      for (i = 0; i < num; i++)
+      {
+         digit = _zz_multi_powm_digit(e[i], k*c, c);
+
+         if (digit != 0)
+         {
+            if (used[digit - 1])
+               nn_mont_mul_tmp(bucket + (digit - 1)*n, 
+                   bucket + (digit - 1)*n, x + i*n, d, n, dinv, s);
+            else
+               nn_copy(bucket + (digit - 1)*n, x + i*n, n);
+            used[digit - 1] = 1;
+         }
+      }
+
+      /* t *= prod_j bucket[j - 1]^j, skipping empty buckets */
+      for (started = 0, j = blen - 1; j >= 0; j--)
+      {
+         if (used[j])
+         {
+            if (started)
+               nn_mont_mul_tmp(run, run, bucket + j*n, d, n, dinv, s);
+            else
+               nn_copy(run, bucket + j*n, n);
+            started = 1;
+         }
+
+         if (started)
+         {
+            if (first)
+               nn_copy(t, run, n);
+            else
+               nn_mont_mul_tmp(t, t, run, d, n, dinv, s);
+            first = 0;
+         }
+      }
+   }
+
+   TMP_END;
+}
+
+void zz_multi_powm(zz_ptr r, zz_srcptr * g, zz_srcptr * e, 
+                                              size_t num, zz_srcptr m)
+{
+   const len_t n = BSDNT_ABS(m->size);
+   hensel_preinv1_t dinv;
+   bits_t bits = 0, b;
+   double cost, scost = -1.0, pcost = -1.0;
+   int c, w = 1, p = 1;
+   word_t one = 1;
+   size_t i;
+   nn_t x, tmp;
+   zz_t t, s, q, d;
+   TMP_INIT;
+
+   ASSERT(n != 0);
+
+   if ((m->n[0] & 1) == 0) /* no Montgomery form, use zz_powm */
+   {
+      zz_init(s);
+      zz_init(t);
+      zz_init(q);
+      zz_init(d);
+      zz_set(d, m);
+      if (d->size < 0)
+         zz_neg(d, d);
+
+      zz_seti(s, 1);
+      zz_divrem(q, s, s, d);
+
+      for (i = 0; i < num; i++)
+      {
+         ASSERT(e[i]->size >= 0);
+
+         zz_powm(t, g[i], e[i], d);
+         zz_mul(s, s, t);
+         zz_divrem(q, s, s, d);
+      }
+
+      zz_swap(r, s);
+      zz_clear(s);
+      zz_clear(t);
+      zz_clear(q);
+      zz_clear(d);
+
+      return;
+   }
+
+   for (i = 0; i < num; i++)
+   {
+      ASSERT(e[i]->size >= 0);
+
+      if (e[i]->size != 0)
+      {
+         b = e[i]->size*WORD_BITS - high_zero_bits(e[i]->n[e[i]->size - 1]);
+         bits = BSDNT_MAX(bits, b);
+      }
+   }
+
+   zz_init_fit(t, n);
+   precompute_hensel_inverse1(&dinv, m->n[0]);
+
+   TMP_START;
+   x = (nn_t) TMP_ALLOC(num*n);
+   tmp = (nn_t) TMP_ALLOC(2*n);
+   
+   nn_mont_set(t->n, &one, 1, m->n, n);
+
+   if (bits != 0)
+   {
+      /* bases into Montgomery form in [0, |m|) */
+      for (i = 0; i < num; i++)
+      {
+         nn_mont_set(x + i*n, g[i]->n, BSDNT_ABS(g[i]->size), m->n, n);
+         if (g[i]->size < 0 && nn_normalise(x + i*n, n) != 0)
+            nn_sub_m(x + i*n, m->n, x + i*n, n);
+      }
+
+      /* count the products each method needs for window sizes up to 16 */
+      for (c = 1; c <= 16; c++)
+      {
+         cost = (double) num*((WORD(1) << c) - 2) 
+              + (double) num*((bits + c - 1)/c) + bits;
+         if (scost < 0 || cost < scost)
+         {
+            scost = cost;
+            w = c;
+         }
+
+         cost = (double) ((bits + c - 1)/c)*(num + (WORD(2) << c)) + bits;
+         if (pcost < 0 || cost < pcost)
+         {
+            pcost = cost;
+            p = c;
+         }
+      }
+
+      if (scost <= pcost)
+         _zz_multi_powm_straus(t->n, x, e, num, bits, w, 
+                                                     m->n, n, dinv, tmp);
+      else
+         _zz_multi_powm_pippenger(t->n, x, e, num, bits, p, 
+                                                     m->n, n, dinv, tmp);
+   }
+
+   nn_mont_get(t->n, t->n, m->n, n, dinv);
+   t->size = nn_normalise(t->n, n);
+
+   TMP_END;
+
+   zz_swap(r, t);
+   zz_clear(t);
+}
+
+void zz_sqrtrem(zz_ptr s, zz_ptr r, zz_srcptr a)
 {
-   char * str = zz_get_str(a);
+   const len_t m = a->size, n = (m + 1)/2;
+   zz_t t, u;
+
+   ASSERT(m >= 0);
+
+   if (m == 0)
+   {
+      zz_zero(s);
+      zz_zero(r);
+      return;
+   }
 
-   printf("%s", str);
+   zz_init_fit(t, n);
+   zz_init_fit(u, n + 1);
 
-   free(str);
+   u->size = nn_sqrtrem(t->n, u->n, a->n, m);
+   t->size = nn_normalise(t->n, n);
+
+   zz_swap(s, t);
+   zz_swap(r, u);
+   
+   zz_clear(t);
+   zz_clear(u);
+}
+
+void zz_sqrt(zz_ptr s, zz_srcptr a)
+{
+   zz_t r;
+
+   zz_init(r);
+   zz_sqrtrem(s, r, a);
+   zz_clear(r);
+}
+
+/*
+   Set r to the integer part of d >= 0, i.e. d truncated, by scaling 
+   its 53 bit mantissa. The result is never more than d.
+*/
+static
+void _zz_set_d(zz_ptr r, double d)
+{
+   int e;
+   double f = frexp(d, &e);
+
+   zz_seti(r, (sword_t) ldexp(f, 53));
+   
+   if (e >= 53)
+      zz_mul_2exp(r, r, e - 53);
+   else
+      zz_div_2exp(r, r, 53 - e);
+}
+
+/*
+   Return an approximation to log2(a) for a > 0, from its top two words.
+*/
+static
+double _zz_log2(zz_srcptr a)
+{
+   const len_t m = BSDNT_ABS(a->size);
+   double l = (double) a->n[m - 1];
+
+   if (m > 1)
+      l = ldexp(l, WORD_BITS) + (double) a->n[m - 2];
+   
+   return log2(l) + (double) (BSDNT_MAX(m - 2, 0)*WORD_BITS);
+}
+
+/*
+   Set x = floor(a^(1/k)) where a > 0 has the given number of bits and
+   k >= 2. The top of the root is found recursively from the top bits 
+   of a, with about half the precision plus c guard bits, so that a 
+   single Newton step at full precision from above leaves an error of
+   at most one or two. Small roots are seeded from a double and 
+   refined by Newton iteration.
+*/
+static
+void _zz_root(zz_ptr x, zz_srcptr a, word_t k, bits_t bits)
+{
+   const bits_t b = (bits + k - 1)/k;
+   const bits_t c = 2 + (WORD_BITS - high_zero_bits(k) + 1)/2;
+   bits_t h, s;
+   zz_t t, y, q;
+
+   if (b == 1) /* a < 2^k */
+   {
+      zz_seti(x, 1);
+      return;
+   }
+
+   zz_init(t);
+   zz_init(y);
+   zz_init(q);
+
+   if (b <= BSDNT_MAX(2*c + 2, WORD_BITS/2))
+   {
+      /* a seed above the root, then Newton steps while they decrease */
+      _zz_set_d(x, exp2(_zz_log2(a)/k)*(1.0 + ldexp(1.0, -30)));
+      zz_addi(x, x, 2);
+
+      while (1)
+      {
+         zz_pow(t, x, k - 1);
+         zz_div(q, a, t);
+         zz_muli(y, x, k - 1);
+         zz_add(y, y, q);
+         zz_divremi(y, y, k);
+         
+         if (zz_cmp(y, x) >= 0)
+            break;
+
+         zz_swap(x, y);
+      }
+   } else
+   {
+      h = b/2 + c;
+      s = b - h;
+
+      /* x = (root(a >> ks) + 1) << s >= root(a) */
+      zz_div_2exp(t, a, k*s);
+      _zz_root(x, t, k, bits - k*s);
+      zz_addi(x, x, 1);
+      zz_mul_2exp(x, x, s);
+
+      /* one Newton step x = ((k - 1)x + a/x^(k - 1))/k */
+      zz_pow(t, x, k - 1);
+      zz_div(q, a, t);
+      zz_muli(x, x, k - 1);
+      zz_add(x, x, q);
+      zz_divremi(x, x, k);
+
+      /* the step leaves x >= root(a) with an error of a unit or two */
+      zz_pow(t, x, k);
+      while (zz_cmp(t, a) > 0)
+      {
+         zz_subi(x, x, 1);
+         zz_pow(t, x, k);
+      }
+   }
+
+   zz_clear(t);
+   zz_clear(y);
+   zz_clear(q);
+}
+
+void zz_rootrem(zz_ptr r, zz_ptr rem, zz_srcptr a, word_t k)
+{
+   zz_t x, t, u;
+
+   ASSERT(k > 0);
+   ASSERT(a->size >= 0 || (k & 1) == 1);
+
+   if (k == 1 || a->size == 0)
+   {
+      zz_set(r, a);
+      zz_zero(rem);
+      return;
+   }
+
+   zz_init(x);
+   zz_init(t);
+   zz_init(u);
+
+   zz_set(u, a); /* u = |a| */
+   if (u->size < 0)
+      zz_neg(u, u);
+
+   if (k == 2)
+      zz_sqrtrem(x, t, u);
+   else
+   {
+      _zz_root(x, u, k, zz_sizeinbase(u, 2));
+      zz_pow(t, x, k);
+      zz_sub(t, u, t);
+   }
+
+   if (a->size < 0)
+   {
+      zz_neg(x, x);
+      zz_neg(t, t);
+   }
+
+   zz_swap(r, x);
+   zz_swap(rem, t);
+
+   zz_clear(x);
+   zz_clear(t);
+   zz_clear(u);
+}
+
+void zz_root(zz_ptr r, zz_srcptr a, word_t k)
+{
+   zz_t rem;
+
+   zz_init(rem);
+   zz_rootrem(r, rem, a, k);
+   zz_clear(rem);
+}
+
+/*
+   Moduli for the residue filters of zz_is_square and zz_is_perfect_power.
+   Their product M fits in a word, so that one nn_mod1_preinv pass gives
+   the residue of a candidate modulo all of them. Only about 4.5% of 
+   random values are squares modulo 63, 65 and 11, and about one in
+   8000 modulo all twelve. The primes dividing the moduli are listed
+   in the same order, for the filters on odd powers.
+*/
+#if WORD_BITS == 64
+#define ZZ_RESIDUE_MODULI 12
+#define ZZ_RESIDUE_M ((word_t) 922334673882737115ULL)
+#else
+#define ZZ_RESIDUE_MODULI 6
+#define ZZ_RESIDUE_M ((word_t) 334639305UL)
+#endif
+
+static const word_t _zz_res_mod[12] = 
+   { 63, 65, 11, 17, 19, 23, 29, 31, 37, 41, 43, 47 };
+
+static const word_t _zz_res_prime[12] = 
+   { 7, 13, 11, 17, 19, 23, 29, 31, 37, 41, 43, 47 };
+
+/* bit t of row i is set iff t is a square modulo _zz_res_mod[i] */
+static const unsigned char _zz_res_sqr[12][9] = 
+{
+   { 0x93, 0x02, 0x45, 0x12, 0x30, 0x48, 0x02, 0x04, 0x00 }, /* 63 */
+   { 0x13, 0x46, 0x01, 0x66, 0x98, 0x01, 0x8a, 0x21, 0x01 }, /* 65 */
+   { 0x3b, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 11 */
+   { 0x17, 0xa3, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 17 */
+   { 0xf3, 0x0a, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 19 */
+   { 0x5f, 0x33, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 23 */
+   { 0xf3, 0x22, 0xd1, 0x13, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 29 */
+   { 0xb7, 0x47, 0x1d, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00 }, /* 31 */
+   { 0x9b, 0x1e, 0x21, 0x5e, 0x16, 0x00, 0x00, 0x00, 0x00 }, /* 37 */
+   { 0x37, 0x07, 0xb5, 0x82, 0xb3, 0x01, 0x00, 0x00, 0x00 }, /* 41 */
+   { 0x53, 0xee, 0xa3, 0x83, 0x58, 0x03, 0x00, 0x00, 0x00 }, /* 43 */
+   { 0xdf, 0x53, 0x27, 0x1b, 0x35, 0x04, 0x00, 0x00, 0x00 }  /* 47 */
+};
+
+/*
+   Return |a| mod d for a nonzero a, in a single pass.
+*/
+static
+word_t _zz_mod1(zz_srcptr a, word_t d)
+{
+   const len_t m = BSDNT_ABS(a->size);
+   mod_preinv1_t inv;
+
+   if (m == 1)
+      return a->n[0] % d;
+
+   precompute_mod_inverse1(&inv, d);
+
+   return nn_mod1_preinv(a->n, m, d, inv);
+}
+
+/*
+   Return b^e mod d, where d is nonzero.
+*/
+static
+word_t _zz_powmod1(word_t b, word_t e, word_t d)
+{
+   dword_t x = 1, y = b % d;
+
+   for ( ; e != 0; e >>= 1)
+   {
+      if (e & 1)
+         x = (x*y) % d;
+      y = (y*y) % d;
+   }
+
+   return (word_t) (x % d);
+}
+
+/*
+   Return the number of trailing zero bits of the nonzero a, and set 
+   *lo to the bottom word of a shifted right by that many bits.
+*/
+static
+bits_t _zz_val2(word_t * lo, zz_srcptr a)
+{
+   const len_t m = BSDNT_ABS(a->size);
+   len_t i = 0;
+   int s;
+
+   while (a->n[i] == 0)
+      i++;
+
+   s = low_zero_bits(a->n[i]);
+   (*lo) = a->n[i] >> s;
+   if (s != 0 && i + 1 < m)
+      (*lo) |= a->n[i + 1] << (WORD_BITS - s);
+
+   return i*WORD_BITS + s;
+}
+
+/*
+   Return 0 if the nonzero a, with 2-adic valuation v, odd part having
+   bottom word lo, and with res = |a| mod M, is certainly not a square,
+   otherwise 1. A square has even valuation and odd part 1 mod 8.
+*/
+static
+int _zz_sqr_filter(bits_t v, word_t lo, word_t res)
+{
+   word_t t;
+   long i;
+
+   if ((v & 1) != 0 || (lo & 7) != 1)
+      return 0;
+
+   for (i = 0; i < ZZ_RESIDUE_MODULI; i++)
+   {
+      t = res % _zz_res_mod[i];
+      if (((_zz_res_sqr[i][t >> 3] >> (t & 7)) & 1) == 0)
+         return 0;
+   }
+
+   return 1;
+}
+
+int zz_is_square(zz_srcptr a)
+{
+   const len_t m = a->size, n = (m + 1)/2;
+   bits_t v;
+   word_t lo;
+   nn_t s, r;
+   int sq;
+   TMP_INIT;
+
+   if (m <= 0)
+      return m == 0;
+
+   v = _zz_val2(&lo, a);
+   if (!_zz_sqr_filter(v, lo, _zz_mod1(a, ZZ_RESIDUE_M)))
+      return 0;
+
+   TMP_START;
+   
+   s = (nn_t) TMP_ALLOC(n);
+   r = (nn_t) TMP_ALLOC(n + 1);
+
+   sq = (nn_sqrtrem(s, r, a->n, m) == 0);
+
+   TMP_END;
+
+   return sq;
+}
+
+/*
+   The largest p-th root, in bits, which _zz_is_power_p determines from
+   a double.
+*/
+#define ZZ_POWER_SMALL_ROOT BSDNT_MIN(40, WORD_BITS - 1)
+
+/*
+   If the integer u > 1, with the given number of bits, 2-adic 
+   valuation v, odd part having bottom word lo and res = u mod M, is a 
+   p-th power for the prime p, set y to its p-th root and return 1, 
+   otherwise return 0. Residues modulo the primes q = 1 mod p dividing
+   M, and modulo 9 for cubes, reject most candidates. If the root has
+   at most ZZ_POWER_SMALL_ROOT bits it is determined from a double and 
+   its power checked modulo B and M, otherwise the residue r of u 
+   modulo the prime d = 1 mod p, as computed by _zz_power_residues, and
+   then modulo the next prime q = 1 mod 2p, are checked before the root
+   is taken. 
+*/
+static
+int _zz_is_power_p(zz_ptr y, zz_srcptr u, word_t p, bits_t bits, 
+                    double l, bits_t v, word_t lo, word_t res,
+                    word_t d, word_t r)
+{
+   const bits_t b = (bits + p - 1)/p;
+   word_t q, t, x, c;
+   long i;
+   int pow;
+   zz_t w;
+
+   if (p == 2)
+   {
+      if (!_zz_sqr_filter(v, lo, res))
+         return 0;
+
+      zz_init(w);
+      zz_sqrtrem(y, w, u);
+      pow = (w->size == 0);
+      zz_clear(w);
+
+      return pow;
+   }
+
+   if (p == 3)
+   {
+      t = res % 9;
+      if (t != 0 && t != 1 && t != 8)
+         return 0;
+   }
+
+   for (i = 0; i < ZZ_RESIDUE_MODULI; i++)
+   {
+      q = _zz_res_prime[i];
+      if (q > 2*p && q % p == 1)
+      {
+         t = res % q;
+         if (t != 0 && _zz_powmod1(t, (q - 1)/p, q) != 1)
+            return 0;
+      }
+   }
+
+   if (b <= ZZ_POWER_SMALL_ROOT)
+   {
+      /* the root is within one of the nearest integer to 2^(log2(u)/p) */
+      x = (word_t) (exp2(l/p) + 0.5);
+
+      for (c = BSDNT_MAX(x, 3) - 1; c <= x + 1; c++)
+      {
+         /* for odd p, c^p = c mod 8 if c is odd and 0 mod 8 otherwise */
+         if (((c & 1) ? (c & 7) : 0) != (u->n[0] & 7))
+            continue;
+
+         /* compare c^p with u modulo B, then modulo M */
+         for (t = 1, q = c, i = p; i != 0; i >>= 1, q *= q)
+            if (i & 1)
+               t *= q;
+
+         if (t == u->n[0] && _zz_powmod1(c, p, ZZ_RESIDUE_M) == res)
+         {
+            zz_init(w);
+            zz_seti(y, (sword_t) c);
+            zz_pow(w, y, p);
+            pow = zz_equal(w, u);
+            zz_clear(w);
+            
+            if (pow)
+               return 1;
+         }
+      }
+
+      return 0;
+   }
+
+   ASSERT(d != 0);
+
+   if (r != 0 && _zz_powmod1(r, (d - 1)/p, d) != 1)
+      return 0;
+
+   /* only about one in p exponents gets here, so a pass over u is cheap */
+   for (q = d + 2*p; !n_is_prime(q); q += 2*p) ;
+
+   t = _zz_mod1(u, q);
+   if (t != 0 && _zz_powmod1(t, (q - 1)/p, q) != 1)
+      return 0;
+
+   zz_init(w);
+   zz_rootrem(y, w, u, p);
+   pow = (w->size == 0);
+   zz_clear(w);
+
+   return pow;
+}
+
+/* 
+   Whether the odd value i is marked composite in a sieve of odd values
+*/
+#define ZZ_ODD_COMPOSITE(odd, i) \
+   (((odd)[(i)/(2*WORD_BITS)] >> (((i)/2) % WORD_BITS)) & 1)
+
+/*
+   Set bit i of odd, which has n/(2*WORD_BITS) + 1 words, iff 2i + 1 < n
+   is composite, by the sieve of Eratosthenes.
+*/
+static
+void _zz_sieve_odd(nn_t odd, bits_t n)
+{
+   bits_t i, j;
+
+   nn_zero(odd, n/(2*WORD_BITS) + 1);
+   
+   for (i = 3; i*i < n; i += 2)
+      if (!ZZ_ODD_COMPOSITE(odd, i))
+         for (j = i*i; j < n; j += 2*i)
+            odd[j/(2*WORD_BITS)] |= ((word_t) 1) << ((j/2) % WORD_BITS);
+}
+
+/*
+   For each prime 2 < p < n, as given by the sieve odd, with p | v if 
+   v != 0 and for which a p-th root of the integer u > 1 of the given 
+   number of bits has more than ZZ_POWER_SMALL_ROOT bits, set ps[j] = p,
+   set d[j] to the least prime q = 1 mod 2p and r[j] to u mod d[j], and
+   return the number of such p. All the residues are found by a single
+   nn_multi_mod, rather than a pass over u for each p. The arrays need
+   space for bits/(2*ZZ_POWER_SMALL_ROOT) + 1 entries.
+*/
+static
+len_t _zz_power_residues(word_t * ps, nn_t d, nn_t r, zz_srcptr u,
+                         nn_src_t odd, bits_t n, bits_t bits, bits_t v)
+{
+   word_t p, q;
+   len_t j = 0;
+
+   for (p = 3; p < n && (bits + p - 1)/p > ZZ_POWER_SMALL_ROOT; p += 2)
+   {
+      if (ZZ_ODD_COMPOSITE(odd, p) || (v != 0 && (v % p) != 0))
+         continue;
+
+      for (q = 2*p + 1; !n_is_prime(q); q += 2*p) ;
+      
+      ps[j] = p;
+      d[j++] = q;
+   }
+
+   if (j != 0)
+      nn_multi_mod(r, u->n, u->size, d, j);
+
+   return j;
+}
+
+word_t zz_is_perfect_power(zz_ptr r, zz_srcptr a)
+{
+   const int neg = (a->size < 0);
+   word_t k = 1, p = neg ? 3 : 2, lo, res;
+   word_t * ps;
+   bits_t bits, v, n;
+   nn_t odd, d, rd;
+   len_t j = 0, np;
+   double l;
+   zz_t u, y;
+   TMP_INIT;
+
+   if (a->size == 0 || (BSDNT_ABS(a->size) == 1 && a->n[0] == 1))
+   {
+      if (r != NULL)
+         zz_set(r, a);
+      return neg ? 3 : 2;
+   }
+
+   zz_init(u);
+   zz_init(y);
+
+   zz_set(u, a); /* u = |a| */
+   if (neg)
+      zz_neg(u, u);
+
+   bits = zz_sizeinbase(u, 2);
+   l = _zz_log2(u);
+   v = _zz_val2(&lo, u);
+   res = _zz_mod1(u, ZZ_RESIDUE_M);
+
+   /* 
+      a p-th power of y >= 2 has more than p bits, and the valuation of
+      a p-th power is a multiple of p, so that v = 1 is never a power
+   */
+   n = (v == 0 ? bits : BSDNT_MIN(bits, v + 1));
+
+   TMP_START;
+   
+   odd = (nn_t) TMP_ALLOC(n/(2*WORD_BITS) + 1);
+   _zz_sieve_odd(odd, n);
+
+   /* residues for the exponents with large roots, bits only decreases */
+   np = bits/(2*ZZ_POWER_SMALL_ROOT) + 1;
+   ps = (word_t *) TMP_ALLOC(np);
+   d = (nn_t) TMP_ALLOC(np);
+   rd = (nn_t) TMP_ALLOC(np);
+   np = _zz_power_residues(ps, d, rd, u, odd, n, bits, v);
+
+   while ((bits_t) p < bits && (v == 0 || (bits_t) p <= v))
+   {
+      while (j < np && ps[j] < p)
+         j++;
+
+      if ((v % p) == 0 && _zz_is_power_p(y, u, p, bits, l, v, lo, res,
+                        j < np && ps[j] == p ? d[j] : 0, rd[j]))
+      {
+         /* a p-th root which is a q-th power was rejected for q < p */
+         zz_swap(u, y);
+         k *= p;
+
+         bits = zz_sizeinbase(u, 2);
+         l = _zz_log2(u);
+         v = _zz_val2(&lo, u);
+         res = _zz_mod1(u, ZZ_RESIDUE_M);
+         np = _zz_power_residues(ps, d, rd, u, odd, n, bits, v);
+         j = 0;
+      } else
+         do p += 1 + (p != 2); while ((bits_t) p < n && ZZ_ODD_COMPOSITE(odd, p));
+   }
+
+   TMP_END;
+
+   if (k > 1 && r != NULL)
+   {
+      if (neg)
+         zz_neg(u, u);
+      zz_swap(r, u);
+   }
+
+   zz_clear(u);
+   zz_clear(y);
+
+   return k == 1 ? 0 : k;
+}
+
+/*
+   Set {r, n} = {a, n} + {b, n}, resp. {a, n} - {b, n}, mod {d, n} for
+   a, b < d. The output may alias a or b.
+*/
+static
+void _nn_addmod(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n)
+{
+   if (nn_add_m(r, a, b, n) || nn_cmp_m(r, d, n) >= 0)
+      nn_sub_m(r, r, d, n);
+}
+
+static
+void _nn_submod(nn_t r, nn_src_t a, nn_src_t b, nn_src_t d, len_t n)
+{
+   if (nn_sub_m(r, a, b, n))
+      nn_add_m(r, r, d, n);
+}
+
+/*
+   Set {r, n} = {a, n}*c mod {d, n} for a < d and a small word c. As 
+   Montgomery form is linear, this also multiplies Montgomery forms by c.
+*/
+static
+void _nn_mulmod1(nn_t r, nn_src_t a, word_t c, nn_src_t d, len_t n)
+{
+   word_t ci = nn_mul1(r, a, n, c);
+
+   while (ci || nn_cmp_m(r, d, n) >= 0)
+      ci -= nn_sub_m(r, r, d, n);
+}
+
+/*
+   Return the number of trailing zero bits of the nonzero {a, n}.
+*/
+static
+bits_t _nn_val2(nn_src_t a, len_t n)
+{
+   len_t i = 0;
+
+   while (a[i] == 0)
+      i++;
+
+   return i*WORD_BITS + low_zero_bits(a[i]);
+}
+
+/* 
+   Bit i of the nn_t a 
+*/
+#define ZZ_BIT(a, i) \
+   (((a)[(i)/WORD_BITS] >> ((i) % WORD_BITS)) & 1)
+
+/*
+   Return 1 if the odd {a, n} > 1 is a strong probable prime to base 2, 
+   otherwise 0. Here one = B^n mod a and dinv is the Hensel inverse of
+   a[0]. Working in Montgomery form, 2^d for a - 1 = d*2^s is built from
+   the top bit down by squarings and doublings, the latter being only
+   an addition.
+*/
+static
+int _nn_is_sprp2(nn_src_t a, len_t n, nn_src_t one, 
+                                                  hensel_preinv1_t dinv)
+{
+   bits_t i, s;
+   nn_t x, m1;
+   int prp = 0;
+   TMP_INIT;
+
+   TMP_START;
+
+   x = (nn_t) TMP_ALLOC(n);
+   m1 = (nn_t) TMP_ALLOC(n);
+
+   nn_sub1(x, a, n, 1);
+   s = _nn_val2(x, n);
+
+   nn_sub_m(m1, a, one, n); /* Montgomery form of -1 */
+   nn_copy(x, one, n);
+
+   /* the bits of d are those of a above bit s */
+   for (i = n*WORD_BITS - high_zero_bits(a[n - 1]) - 1; i >= s; i--)
+   {
+      nn_mont_mul(x, x, x, a, n, dinv);
+      if (ZZ_BIT(a, i))
+         _nn_addmod(x, x, x, a, n);
+   }
+
+   if (nn_cmp_m(x, one, n) == 0)
+      prp = 1;
+
+   for (i = 0; i < s && !prp; i++)
+   {
+      if (nn_cmp_m(x, m1, n) == 0)
+         prp = 1;
+      else
+         nn_mont_mul(x, x, x, a, n, dinv);
+   }
+
+   TMP_END;
+
+   return prp;
+}
+
+/*
+   Return 1 if the odd {a, n} > 1 is a strong Lucas probable prime with
+   P = 1 and Q = (1 - D)/4, where (D/a) = -1, otherwise 0. Here one and
+   dinv are as for _nn_is_sprp2. With a + 1 = d*2^s, the Lucas sequence
+   V_k is taken to k = d by a ladder on (V_k, V_{k + 1}, Q^k) in 
+   Montgomery form, with U_d = 0 iff 2V_{d + 1} = V_d. For Q = -1, the
+   powers of Q are simply +-1 and are not multiplied out.
+*/
+static
+int _nn_is_slprp(nn_src_t a, len_t n, nn_src_t one, 
+                                        hensel_preinv1_t dinv, sword_t D)
+{
+   const sword_t Q = (1 - D)/4;
+   bits_t i, s;
+   len_t dn;
+   nn_t d, v0, v1, qk, qk1, qm, t;
+   int prp = 0;
+   TMP_INIT;
+
+   TMP_START;
+
+   d = (nn_t) TMP_ALLOC(n + 1);
+   v0 = (nn_t) TMP_ALLOC(n);
+   v1 = (nn_t) TMP_ALLOC(n);
+   qk = (nn_t) TMP_ALLOC(n);
+   qk1 = (nn_t) TMP_ALLOC(n);
+   qm = (nn_t) TMP_ALLOC(n);
+   t = (nn_t) TMP_ALLOC(n);
+
+   d[n] = nn_add1(d, a, n, 1);
+   s = _nn_val2(d, n + 1);
+
+   _nn_mulmod1(qm, one, (word_t) BSDNT_ABS(Q), a, n);
+   if (Q < 0)
+      nn_sub_m(qm, a, qm, n);
+
+   _nn_addmod(v0, one, one, a, n);
+   nn_copy(v1, one, n);
+   nn_copy(qk, one, n);
+
+   dn = nn_normalise(d, n + 1);
+   for (i = dn*WORD_BITS - high_zero_bits(d[dn - 1]) - 1; i >= s; i--)
+   {
+      nn_mont_mul(t, v0, v1, a, n, dinv);
+      
+      if (ZZ_BIT(d, i)) /* k -> 2k + 1 */
+      {
+         _nn_submod(v0, t, qk, a, n);
+         if (Q == -1)
+            nn_sub_m(qk1, a, qk, n);
+         else
+            nn_mont_mul(qk1, qk, qm, a, n, dinv);
+         nn_mont_mul(v1, v1, v1, a, n, dinv);
+         _nn_submod(v1, v1, qk1, a, n);
+         _nn_submod(v1, v1, qk1, a, n);
+         if (Q == -1)
+            nn_copy(qk, qm, n);
+         else
+            nn_mont_mul(qk, qk, qk1, a, n, dinv);
+      } else /* k -> 2k */
+      {
+         _nn_submod(v1, t, qk, a, n);
+         nn_mont_mul(v0, v0, v0, a, n, dinv);
+         _nn_submod(v0, v0, qk, a, n);
+         _nn_submod(v0, v0, qk, a, n);
+         if (Q == -1)
+            nn_copy(qk, one, n);
+         else
+            nn_mont_mul(qk, qk, qk, a, n, dinv);
+      }
+   }
+
+   /* D*U_d = 2V_{d + 1} - V_d */
+   _nn_addmod(t, v1, v1, a, n);
+   if (nn_cmp_m(t, v0, n) == 0)
+      prp = 1;
+
+   for (i = 0; i < s && !prp; i++)
+   {
+      if (nn_normalise(v0, n) == 0)
+         prp = 1;
+      else
+      {
+         nn_mont_mul(v0, v0, v0, a, n, dinv);
+         _nn_submod(v0, v0, qk, a, n);
+         _nn_submod(v0, v0, qk, a, n);
+         if (Q == -1)
+            nn_copy(qk, one, n);
+         else
+            nn_mont_mul(qk, qk, qk, a, n, dinv);
+      }
+   }
+
+   TMP_END;
+
+   return prp;
+}
+
+/*
+   Return the Jacobi symbol (D/a) for odd a > 1 and odd D, by 
+   reciprocity from a mod |D|.
+*/
+static
+int _zz_jacobi_si(zz_srcptr a, sword_t D)
+{
+   const word_t e = BSDNT_ABS(D);
+   int j = n_jacobi(_zz_mod1(a, e), e);
+
+   if ((e & 2) && (a->n[0] & 2)) /* both 3 mod 4 */
+      j = -j;
+
+   if (D < 0 && (a->n[0] & 2)) /* (-1/a) = -1 */
+      j = -j;
+
+   return j;
+}
+
+int zz_is_probab_prime(zz_srcptr a)
+{
+   const len_t n = a->size;
+   hensel_preinv1_t dinv;
+   word_t res, w = 1;
+   sword_t D;
+   long i;
+   int j, prp;
+   nn_t one;
+   TMP_INIT;
+
+   if (n <= 1)
+      return n == 1 && n_is_prime(a->n[0]) ? 2 : 0;
+
+   if ((a->n[0] & 1) == 0)
+      return 0;
+
+   /* trial division by the odd primes dividing M, in one pass */
+   res = _zz_mod1(a, ZZ_RESIDUE_M);
+   if (res % 3 == 0 || res % 5 == 0)
+      return 0;
+   for (i = 0; i < ZZ_RESIDUE_MODULI; i++)
+      if (res % _zz_res_prime[i] == 0)
+         return 0;
+
+   TMP_START;
+
+   one = (nn_t) TMP_ALLOC(n);
+   nn_mont_set(one, &w, 1, a->n, n);
+   precompute_hensel_inverse1(&dinv, a->n[0]);
+
+   prp = _nn_is_sprp2(a->n, n, one, dinv);
+
+   /* no D below has (D/a) = -1 if a is a square */
+   if (prp && zz_is_square(a))
+      prp = 0;
+
+   if (prp)
+   {
+      /* Selfridge's choice of D in 5, -7, 9, -11, ... with (D/a) = -1 */
+      for (D = 5; (j = _zz_jacobi_si(a, D)) == 1; )
+         D = (D > 0 ? -D - 2 : -D + 2);
+      
+      /* for j = 0, |D| < a shares a factor with a */
+      prp = (j == -1 && _nn_is_slprp(a->n, n, one, dinv, D));
+   }
+
+   TMP_END;
+
+   return prp;
+}
+
+/*
+   Mark the odd multiples of each sieving prime in the current segment
+   of S and move the offset of each prime on to the next segment.
+*/
+static
+void _zz_sieve_segment(zz_sieve_t S)
+{
+   const bits_t bits = S->bits;
+   nn_t seg = S->seg;
+   bits_t i, p;
+   long j;
+
+   nn_zero(seg, bits/WORD_BITS);
+
+   for (j = 0; j < S->num; j++)
+   {
+      p = S->primes[j];
+      for (i = S->offsets[j]; i < bits; i += p)
+         seg[i/WORD_BITS] |= ((word_t) 1) << (i % WORD_BITS);
+      S->offsets[j] = i - bits;
+   }
+
+   S->pos = 0;
+}
+
+void zz_sieve_init(zz_sieve_t S, zz_srcptr a, word_t bound)
+{
+   const bits_t nbits = zz_sizeinbase(a, 2);
+   nn_t odd, s;
+   word_t p, d, r, t, s0;
+   mod_preinv1_t inv;
+   len_t m;
+   long i, j, k;
+   TMP_INIT;
+
+   ASSERT(a->size >= 0);
+
+   zz_init(&S->start);
+   zz_set(&S->start, a);
+   if (a->size == 0 || (a->n[0] & 1) == 0)
+      zz_addi(&S->start, &S->start, 1);
+
+   if (bound == 0)
+      bound = BSDNT_MIN(WORD(1) << 20, BSDNT_MAX(1000, nbits*nbits/16));
+
+   S->bits = BSDNT_MIN(ZZ_SIEVE_BITS, 
+                      ((4*nbits + WORD_BITS - 1)/WORD_BITS)*WORD_BITS);
+   S->seg = (nn_t) malloc((S->bits/WORD_BITS)*sizeof(word_t));
+
+   TMP_START;
+
+   /* the odd primes up to bound */
+   odd = (nn_t) TMP_ALLOC((bound + 1)/(2*WORD_BITS) + 1);
+   _zz_sieve_odd(odd, bound + 1);
+
+   for (S->num = 0, p = 3; p <= bound; p += 2)
+      S->num += !ZZ_ODD_COMPOSITE(odd, p);
+
+   S->primes = (word_t *) malloc(S->num*sizeof(word_t));
+   S->offsets = (bits_t *) malloc(S->num*sizeof(bits_t));
+
+   for (i = 0, p = 3; p <= bound; p += 2)
+      if (!ZZ_ODD_COMPOSITE(odd, p))
+         S->primes[i++] = p;
+
+   TMP_END;
+
+   /* start mod p, for groups of primes whose product d fits in a word */
+   s = S->start.n;
+   m = S->start.size;
+   s0 = s[0];
+   
+   for (j = 0; j < S->num; j = k)
+   {
+      d = S->primes[j];
+      for (k = j + 1; k < S->num && d <= ((word_t) -1)/S->primes[k]; k++)
+         d *= S->primes[k];
+
+      if (m == 1)
+         r = s0 % d;
+      else
+      {
+         precompute_mod_inverse1(&inv, d);
+         r = nn_mod1_preinv(s, m, d, inv);
+      }
+
+      /* the first bit i with p | start + 2i, skipping p itself */
+      for (i = j; i < k; i++)
+      {
+         p = S->primes[i];
+         t = r % p;
+         t = (t == 0 ? 0 : p - t);
+         t = ((t & 1) ? (t + p)/2 : t/2);
+         if (m == 1 && s0 <= p && s0 + 2*t == p)
+            t += p;
+         S->offsets[i] = t;
+      }
+   }
+
+   _zz_sieve_segment(S);
+}
+
+void zz_sieve_clear(zz_sieve_t S)
+{
+   free(S->primes);
+   free(S->offsets);
+   free(S->seg);
+   zz_clear(&S->start);
+}
+
+void zz_sieve_next(zz_ptr r, zz_sieve_t S)
+{
+   zz_t t;
+
+   zz_init(t);
+
+   while (1)
+   {
+      for ( ; S->pos < S->bits; S->pos++)
+      {
+         if (S->seg[S->pos/WORD_BITS] == ~WORD(0)) /* skip full words */
+         {
+            S->pos += WORD_BITS - 1 - S->pos % WORD_BITS;
+            continue;
+         }
+
+         if (((S->seg[S->pos/WORD_BITS] >> (S->pos % WORD_BITS)) & 1) == 0)
+         {
+            zz_addi(t, &S->start, 2*S->pos);
+            if (zz_is_probab_prime(t))
+            {
+               S->pos++;
+               zz_swap(r, t);
+               zz_clear(t);
+
+               return;
+            }
+         }
+      }
+
+      zz_addi(&S->start, &S->start, 2*S->bits);
+      _zz_sieve_segment(S);
+   }
+}
+
+void zz_nextprime(zz_ptr r, zz_srcptr a)
+{
+   zz_sieve_t S;
+   zz_t t;
+
+   if (zz_cmpi(a, 2) < 0)
+   {
+      zz_seti(r, 2);
+      return;
+   }
+
+   zz_init(t);
+   zz_addi(t, a, 1);
+
+   zz_sieve_init(S, t, 0);
+   zz_sieve_next(r, S);
+   zz_sieve_clear(S);
+
+   zz_clear(t);
+}
+
+void zz_random_prime(zz_ptr r, bits_t bits, rand_t state)
+{
+   const len_t m = (bits + WORD_BITS - 1)/WORD_BITS;
+   const int b = (bits - 1) % WORD_BITS;
+   zz_t t;
+
+   ASSERT(bits >= 2);
+
+   zz_init_fit(t, m);
+
+   do
+   {
+      /* a random value of exactly the given number of bits, less one */
+      nn_random(t->n, state, m);
+      t->n[m - 1] &= (WORD(1) << b) - 1;
+      t->n[m - 1] |= WORD(1) << b;
+      t->size = m;
+      zz_subi(t, t, 1);
+
+      zz_nextprime(t, t);
+   } while (zz_sizeinbase(t, 2) > (size_t) bits);
+
+   zz_swap(r, t);
+   zz_clear(t);
+}
+
+void zz_prodtree_init(zz_prodtree_t T, zz_srcptr * in, size_t n)
+{
+   zz_struct * lo, * hi;
+   size_t i, m;
+   len_t d;
+
+   ASSERT(n > 0);
+
+   for (d = 1, m = n; m > 1; d++)
+      m = (m + 1)/2;
+
+   T->depth = d;
+   T->level = (zz_struct **) malloc(d*sizeof(zz_struct *));
+   T->len = (size_t *) malloc(d*sizeof(size_t));
+
+   lo = T->level[0] = (zz_struct *) malloc(n*sizeof(zz_struct));
+   T->len[0] = n;
+
+   for (i = 0; i < n; i++)
+   {
+      zz_init(lo + i);
+      zz_set(lo + i, in[i]);
+   }
+
+   for (d = 1; d < T->depth; d++)
+   {
+      lo = T->level[d - 1];
+      m = T->len[d - 1];
+      
+      T->len[d] = (m + 1)/2;
+      hi = T->level[d] = (zz_struct *) malloc(T->len[d]*sizeof(zz_struct));
+
+      for (i = 0; i < m/2; i++)
+      {
+         zz_init(hi + i);
+         zz_mul(hi + i, lo + 2*i, lo + 2*i + 1);
+      }
+
+      if (m & 1) /* unpaired entry */
+      {
+         zz_init(hi + i);
+         zz_set(hi + i, lo + m - 1);
+      }
+   }
+}
+
+void zz_prodtree_clear(zz_prodtree_t T)
+{
+   size_t i;
+   len_t d;
+
+   for (d = 0; d < T->depth; d++)
+   {
+      for (i = 0; i < T->len[d]; i++)
+         zz_clear(T->level[d] + i);
+
+      free(T->level[d]);
+   }
+
+   free(T->level);
+   free(T->len);
+}
+
+/*
+   Given P, return an array of the values P mod x_i^2 for the leaves
+   x_i of the product tree T. The remainders are computed one level 
+   at a time, from the root down, so that only two levels of them are
+   ever live at once. The caller must clear the T->len[0] entries and
+   free the array.
+*/
+static
+zz_struct * _zz_prodtree_remsqr(zz_prodtree_t T, zz_srcptr P)
+{
+   zz_struct * rem, * next, * lo;
+   zz_t q, sq;
+   size_t i;
+   len_t d;
+
+   zz_init(q);
+   zz_init(sq);
+
+   rem = (zz_struct *) malloc(sizeof(zz_struct));
+   
+   zz_init(rem);
+
+   if (P == zz_prodtree_root(T)) /* P mod P^2 = P */
+      zz_set(rem, P);
+   else
+   {
+      zz_mul(sq, zz_prodtree_root(T), zz_prodtree_root(T));
+      zz_divrem(q, rem, P, sq);
+   }
+
+   for (d = T->depth - 2; d >= 0; d--)
+   {
+      lo = T->level[d];
+      next = (zz_struct *) malloc(T->len[d]*sizeof(zz_struct));
+
+      for (i = 0; i < T->len[d]; i++)
+      {
+         zz_init(next + i);
+         zz_mul(sq, lo + i, lo + i);
+         zz_divrem(q, next + i, rem + i/2, sq);
+      }
+
+      for (i = 0; i < T->len[d + 1]; i++)
+         zz_clear(rem + i);
+      free(rem);
+
+      rem = next;
+   }
+
+   zz_clear(sq);
+   zz_clear(q);
+
+   return rem;
+}
+
+/*
+   Given a product P divisible by the root of the product tree T, set
+   out[i] = gcd(x_i, (P mod x_i^2)/x_i) for each leaf x_i of T.
+*/
+static
+void _zz_batch_gcd_remtree(zz_ptr * out, zz_prodtree_t T, zz_srcptr P)
+{
+   zz_struct * rem = _zz_prodtree_remsqr(T, P);
+   zz_struct * lo = T->level[0];
+   zz_t q;
+   size_t i;
+   
+   zz_init(q);
+
+   for (i = 0; i < T->len[0]; i++)
+   {
+      zz_div(q, rem + i, lo + i); /* exact */
+      zz_gcd(out[i], q, lo + i);
+      zz_clear(rem + i);
+   }
+
+   free(rem);
+   zz_clear(q);
+}
+
+void zz_batch_gcd(zz_ptr * out, zz_srcptr * in, size_t n)
+{
+   if (n != 0)
+      zz_batch_gcd_chunked(out, in, n, n);
+}
+
+void zz_batch_gcd_chunked(zz_ptr * out, zz_srcptr * in, 
+                                                  size_t n, size_t chunk)
+{
+   size_t c, i, num = (n + chunk - 1)/chunk;
+   zz_prodtree_t T;
+   zz_struct * tops;
+   zz_srcptr * ptrs;
+   zz_t P;
+
+   ASSERT(chunk > 0);
+
+   if (n == 0)
+      return;
+
+   if (num == 1) /* everything fits in a single tree */
+   {
+      zz_prodtree_init(T, in, n);
+      _zz_batch_gcd_remtree(out, T, zz_prodtree_root(T));
+      zz_prodtree_clear(T);
+
+      return;
+   }
+
+   /* compute the product of each chunk, then the product of all */
+   tops = (zz_struct *) malloc(num*sizeof(zz_struct));
+   ptrs = (zz_srcptr *) malloc(num*sizeof(zz_srcptr));
+
+   for (c = 0, i = 0; c < num; c++, i += chunk)
+   {
+      zz_prodtree_init(T, in + i, BSDNT_MIN(chunk, n - i));
+      zz_init(tops + c);
+      zz_set(tops + c, zz_prodtree_root(T));
+      zz_prodtree_clear(T);
+      ptrs[c] = tops + c;
+   }
+
+   zz_prodtree_init(T, ptrs, num);
+   zz_init(P);
+   zz_set(P, zz_prodtree_root(T));
+   zz_prodtree_clear(T);
+
+   for (c = 0; c < num; c++)
+      zz_clear(tops + c);
+   free(tops);
+   free(ptrs);
+
+   /* stream P down the tree for each chunk in turn */
+   for (i = 0; i < n; i += chunk)
+   {
+      zz_prodtree_init(T, in + i, BSDNT_MIN(chunk, n - i));
+      _zz_batch_gcd_remtree(out + i, T, P);
+      zz_prodtree_clear(T);
+   }
+
+   zz_clear(P);
+}
+
+void zz_crt_ctx_init(zz_crt_ctx_t ctx, zz_srcptr * mods, size_t n)
+{
+   zz_struct * rem, * lo;
+   zz_t q;
+   size_t i;
+
+   ASSERT(n > 0);
+
+   zz_prodtree_init(ctx->T, mods, n);
+   ctx->n = n;
+   ctx->inv = (zz_struct *) malloc(n*sizeof(zz_struct));
+   
+   /* (M/m_i) mod m_i = (M mod m_i^2)/m_i */
+   rem = _zz_prodtree_remsqr(ctx->T, zz_prodtree_root(ctx->T));
+   lo = ctx->T->level[0];
+
+   zz_init(q);
+
+   for (i = 0; i < n; i++)
+   {
+      zz_div(q, rem + i, lo + i); /* exact */
+      
+      zz_init(ctx->inv + i);
+      zz_invert(ctx->inv + i, q, lo + i);
+      
+      zz_clear(rem + i);
+   }
+
+   free(rem);
+   zz_clear(q);
+}
+
+void zz_crt_ctx_clear(zz_crt_ctx_t ctx)
+{
+   size_t i;
+
+   for (i = 0; i < ctx->n; i++)
+      zz_clear(ctx->inv + i);
+
+   free(ctx->inv);
+   zz_prodtree_clear(ctx->T);
+}
+
+void zz_crt(zz_ptr r, zz_srcptr * res, zz_crt_ctx_t ctx, int sym)
+{
+   zz_prodtree_struct * T = ctx->T;
+   zz_struct * val, * next, * lo;
+   zz_t q, t;
+   size_t i, m;
+   len_t d;
+
+   zz_init(q);
+   zz_init(t);
+
+   /* v_i = r_i*(M/m_i)^-1 mod m_i */
+   val = (zz_struct *) malloc(ctx->n*sizeof(zz_struct));
+   lo = T->level[0];
+
+   for (i = 0; i < ctx->n; i++)
+   {
+      zz_init(val + i);
+      zz_mul(t, res[i], ctx->inv + i);
+      zz_divrem(q, val + i, t, lo + i);
+      if (val[i].size < 0) /* the remainder has the sign of t */
+         zz_add(val + i, val + i, lo + i);
+   }
+
+   /* combine pairs: v = v_L*m_R + v_R*m_L, until v = sum v_i*M/m_i */
+   for (d = 1; d < T->depth; d++)
+   {
+      lo = T->level[d - 1];
+      m = T->len[d - 1];
+      next = (zz_struct *) malloc(T->len[d]*sizeof(zz_struct));
+
+      for (i = 0; i < m/2; i++)
+      {
+         zz_init(next + i);
+         zz_mul(next + i, val + 2*i, lo + 2*i + 1);
+         zz_mul(t, val + 2*i + 1, lo + 2*i);
+         zz_add(next + i, next + i, t);
+      }
+
+      if (m & 1) /* unpaired entry */
+      {
+         zz_init(next + i);
+         zz_set(next + i, val + m - 1);
+      }
+
+      for (i = 0; i < m; i++)
+         zz_clear(val + i);
+      free(val);
+
+      val = next;
+   }
+
+   zz_divrem(q, r, val, zz_prodtree_root(T));
+   
+   if (sym) /* put r in (-M/2, M/2] */
+   {
+      zz_mul_2exp(t, r, 1);
+      
+      if (zz_cmp(t, zz_prodtree_root(T)) > 0)
+         zz_sub(r, r, zz_prodtree_root(T));
+   }
+
+   zz_clear(val);
+   free(val);
+
+   zz_clear(t);
+   zz_clear(q);
+}
+
+size_t zz_sizeinbase(zz_srcptr a, int base)
+{
+   return nn_sizeinbase(a->n, BSDNT_ABS(a->size), base);
+}
+
+size_t zz_set_strn(zz_ptr a, const char * str, size_t n)
+{
+   int sgn = 0;
+   size_t digits = 0;
+   len_t size;
+   
+   if (n > 0 && str[0] == '-') 
+   {
+      sgn = 1;
+      str++;
+      n--;
+   }
+
+   while (digits < n && str[digits] >= '0' && str[digits] <= '9')
+      digits++;
+   
+   if (digits == 0) /* a sign alone is not a number */
+      sgn = 0;
+
+   size = (len_t) ceil(digits*log2(10)/WORD_BITS) + 1;
+   zz_fit(a, size);
+
+   size = nn_set_strn(a->n, str, digits);
+
+   a->size = sgn ? -size : size;
+
+   return digits + sgn;
+}
+
+/*
+   Set r = a*b + c. The output may alias c.
+*/
+static
+void _zz_muladd(zz_ptr r, zz_srcptr a, zz_srcptr b, zz_srcptr c)
+{
+   zz_t t;
+
+   zz_init(t);
+   zz_mul(t, a, b);
+   zz_add(r, t, c);
+   zz_clear(t);
+}
+
+size_t zz_inp_str(zz_ptr a, FILE * f)
+{
+   const size_t B = INP_STR_BLOCK_DIGITS;
+   zz_struct stack[WORD_BITS], pow[WORD_BITS];
+   zz_t t, p;
+   char * buf = (char *) malloc(B + 1);
+   size_t i, r = 0, n = 0, nb = 0, j;
+   len_t levels = 0;
+   int c, sgn = 0;
+
+   while ((c = getc(f)) != EOF && isspace(c))
+      n++;
+
+   if (c == '-')
+   {
+      sgn = 1;
+      n++;
+      c = getc(f);
+   }
+
+   zz_init(t);
+
+   /* 
+      stack[j] holds the value of a block of B*2^j digits if bit j of 
+      nb is set, and pow[j] = 10^(B*2^j) for j < levels
+   */
+   for ( ; c >= '0' && c <= '9'; c = getc(f))
+   {
+      buf[r++] = (char) c;
+      
+      if (r == B)
+      {
+         zz_set_strn(t, buf, B);
+         
+         for (j = 0; nb & (WORD(1) << j); j++)
+         {
+            if (j == levels)
+            {
+               zz_init(pow + j);
+               
+               if (j == 0)
+               {
+                  buf[0] = '1';
+                  for (i = 1; i <= B; i++)
+                     buf[i] = '0';
+                  zz_set_strn(pow, buf, B + 1);
+               } else
+                  zz_mul(pow + j, pow + j - 1, pow + j - 1);
+               
+               levels++;
+            }
+
+            _zz_muladd(t, stack + j, pow + j, t);
+            zz_clear(stack + j);
+         }
+
+         stack[j] = t[0];
+         zz_init(t);
+         
+         nb++;
+         n += r;
+         r = 0;
+      }
+   }
+
+   if (c != EOF)
+      ungetc(c, f);
+
+   if (nb == 0 && r == 0)
+   {
+      n = 0;
+      zz_zero(a);
+   } else
+   {
+      /* combine the remaining digits and blocks, least significant first */
+      zz_set_strn(t, buf, r);
+      n += r;
+      
+      buf[0] = '1';
+      for (i = 1; i <= r; i++)
+         buf[i] = '0';
+      zz_init(p);
+      zz_set_strn(p, buf, r + 1);
+      
+      for (j = 0; nb != 0; j++, nb >>= 1)
+      {
+         if (nb & 1)
+         {
+            _zz_muladd(t, stack + j, p, t);
+            zz_clear(stack + j);
+            
+            if (nb != 1)
+               zz_mul(p, p, pow + j);
+         }
+      }
+
+      zz_clear(p);
+
+      zz_swap(a, t);
+      if (sgn)
+         zz_neg(a, a);
+   }
+
+   for (j = 0; (len_t) j < levels; j++)
+      zz_clear(pow + j);
+
+   zz_clear(t);
+   free(buf);
+
+   return n;
+}
+
+/*
+   Given the string str for the absolute value of a, allocated with 
+   malloc, prepend a '-' if a is negative and return the result.
+*/
+static
+char * _zz_str_sign(char * str, zz_srcptr a)
+{
+   size_t i;
+
+   if (a->size < 0)
+   {
+      size_t len = strlen(str);
+      str = (char *) realloc(str, len + 2);
+      for (i = len + 1; i >= 1; i--)
+         str[i] = str[i - 1];
+      str[0] = '-';
+   }
+
+   return str;
+}
+
+char * zz_get_str_base(zz_srcptr a, int base)
+{
+   len_t size = BSDNT_ABS(a->size);
+   
+   return _zz_str_sign(nn_get_str_base(a->n, size, base), a);
+}
+
+char * zz_get_str(zz_srcptr a)
+{
+   return zz_get_str_base(a, 10);
+}
+
+char * zz_get_str_threaded(zz_srcptr a, long threads)
+{
+   len_t size = BSDNT_ABS(a->size);
+   
+   return _zz_str_sign(nn_get_str_threaded(a->n, size, threads), a);
+}
+
+size_t zz_set_str_base(zz_t a, const char * str, int base)
+{
+   int sgn = 0;
+   len_t size;
+   size_t digits = 0;
+   
+   if (str[0] == '-') 
+   {
+      sgn = 1;
+      str++;
+   }
+
+   while (nn_digit_value(str[digits], base) < base)
+      digits++;
+   
+   /* enough words for digits*log_2(base) bits */
+   size = (len_t) ceil(digits*log2(base)/WORD_BITS) + 1;
+   zz_fit(a, size);
+
+   digits = nn_set_str_base(a->n, &size, str, base);
+
+   a->size = sgn ? -size : size;
+
+   return digits + sgn;
+}
+
+size_t zz_set_str(zz_t a, const char * str)
+{
+   return zz_set_str_base(a, str, 10);
+}
+
+size_t zz_out_str(FILE * f, zz_srcptr a)
+{
+   size_t n = 0;
+
+   if (a->size < 0)
+      n = fwrite("-", 1, 1, f);
+
+   return n + nn_out_str(f, a->n, BSDNT_ABS(a->size));
+}
+
+/*
+   Return the offset in bytes of byte i of word j, counting from the 
+   least significant of each, in a layout of count words of size bytes.
+*/
+static inline
+size_t _zz_byte_offset(size_t j, size_t i, size_t count, 
+                                         int order, size_t size, int endian)
+{
+   if (order > 0)
+      j = count - j - 1;
+
+   if (endian > 0)
+      i = size - i - 1;
+
+   return j*size + i;
+}
+
+void zz_import(zz_ptr r, size_t count, int order, size_t size, 
+                                               int endian, const void * op)
+{
+   const unsigned char * p = (const unsigned char *) op;
+   len_t m = (len_t) ((count*size + sizeof(word_t) - 1)/sizeof(word_t));
+   size_t i, j, k;
+   word_t w;
+
+   if (endian == 0)
+      endian = (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN) ? 1 : -1;
+   
+   zz_fit(r, m);
+
+   if (size == sizeof(word_t))
+   {
+      if (order < 0 && (endian > 0) == (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN))
+         memcpy(r->n, p, count*size);
+      else
+      {
+         for (j = 0; j < count; j++, p += size)
+         {
+            memcpy(&w, p, size);
+            if ((endian > 0) != (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN))
+               w = byte_swap(w);
+            r->n[order < 0 ? j : count - j - 1] = w;
+         }
+      }
+   } else
+   {
+      nn_zero(r->n, m);
+      
+      /* k is the position of the byte in the result */
+      for (j = 0, k = 0; j < count; j++)
+      {
+         for (i = 0; i < size; i++, k++)
+            r->n[k/sizeof(word_t)] |= (word_t) 
+               p[_zz_byte_offset(j, i, count, order, size, endian)] 
+                                           << (8*(k % sizeof(word_t)));
+      }
+   }
+
+   r->size = nn_normalise(r->n, m);
+}
+
+void * zz_export(void * rop, size_t * countp, int order, size_t size, 
+                                                   int endian, zz_srcptr a)
+{
+   unsigned char * p;
+   len_t m = BSDNT_ABS(a->size);
+   size_t count, i, j, k;
+   word_t w;
+
+   if (endian == 0)
+      endian = (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN) ? 1 : -1;
+   
+   count = m == 0 ? 0 : (zz_sizeinbase(a, 2) + 8*size - 1)/(8*size);
+   *countp = count;
+   
+   if (rop == NULL)
+      rop = malloc(BSDNT_MAX(count*size, 1));
+
+   p = (unsigned char *) rop;
+   
+   if (size == sizeof(word_t))
+   {
+      if (order < 0 && (endian > 0) == (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN))
+         memcpy(p, a->n, count*size);
+      else
+      {
+         for (j = 0; j < count; j++, p += size)
+         {
+            w = a->n[order < 0 ? j : count - j - 1];
+            if ((endian > 0) != (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN))
+               w = byte_swap(w);
+            memcpy(p, &w, size);
+         }
+      }
+   } else
+   {
+      /* k is the position of the byte in the input */
+      for (j = 0, k = 0; j < count; j++)
+      {
+         for (i = 0; i < size; i++, k++)
+            p[_zz_byte_offset(j, i, count, order, size, endian)] = 
+               k < m*sizeof(word_t) ? (unsigned char) 
+                  (a->n[k/sizeof(word_t)] >> (8*(k % sizeof(word_t)))) : 0;
+      }
+   }
+
+   return rop;
+}
+
+void zz_print(zz_srcptr a)
+{
+   zz_out_str(stdout, a);
 }
@@ -279,6 +279,365 @@ void zz_gcd(zz_ptr g, zz_srcptr a, zz_srcptr b);
 */
 void zz_xgcd(zz_ptr g, zz_ptr s, zz_ptr t, zz_srcptr a, zz_srcptr b);
 
+/*
+   If a is invertible modulo m, set r to the inverse of a modulo m,
+   with 0 <= r < |m|, and return 1. Otherwise return 0 and leave r
+   unmodified. If |m| = 1 then r is set to 0 and 1 is returned and if
+   m = 0 then 0 is returned. Unlike zz_xgcd only the cofactor that is
+   actually required is computed.
+*/
+int zz_invert(zz_ptr r, zz_srcptr a, zz_srcptr m);
+
+/*
+   Set r = a^k by binary powering. The output may alias a.
+*/
+void zz_pow(zz_ptr r, zz_srcptr a, word_t k);
+
+/*
+   Set r = a^e mod m with 0 <= r < |m| and return 1. If e is negative,
+   a^(-1) mod m is raised to the power -e, and if a is not invertible 
+   modulo m then 0 is returned and r is unmodified. We require m != 0.
+   See nn_powm for the algorithm.
+*/
+int zz_powm(zz_ptr r, zz_srcptr a, zz_srcptr e, zz_srcptr m);
+
+/*
+   Set r = a^e mod m with 0 <= r < |m|, using nn_powm_sec so that the 
+   timing does not depend on the value of e, only on its size. We 
+   require m to be odd and e >= 0.
+*/
+void zz_powm_sec(zz_ptr r, zz_srcptr a, zz_srcptr e, zz_srcptr m);
+
+/*
+   Set r = a mod 2^p - 1 with 0 <= r < 2^p - 1, using 
+   nn_mod_2exp_minus_c, so that no division is done. We require p > 1.
+*/
+void zz_mod_mersenne(zz_ptr r, zz_srcptr a, bits_t p);
+
+/**********************************************************************
+ 
+    Product trees
+
+**********************************************************************/
+
+/*
+   A product tree over n integers. Level 0 holds copies of the leaves
+   and each entry at level i + 1 is the product of the two entries
+   below it at level i (a final unpaired entry is simply copied up).
+   The root, i.e. the product of all the leaves, is the only entry of
+   the top level, level[depth - 1].
+*/
+typedef struct
+{
+   zz_struct ** level; /* level[i] is an array of len[i] entries */
+   size_t * len;
+   len_t depth;
+} zz_prodtree_struct;
+
+typedef zz_prodtree_struct zz_prodtree_t[1];
+
+/*
+   Build the product tree over the n integers in. We require n > 0.
+   The products are balanced, so that the multiplications at each
+   level are of roughly equal size.
+*/
+void zz_prodtree_init(zz_prodtree_t T, zz_srcptr * in, size_t n);
+
+/*
+   Free the memory used by the given product tree.
+*/
+void zz_prodtree_clear(zz_prodtree_t T);
+
+/*
+   Return a pointer to the root of the product tree T.
+*/
+static inline
+zz_srcptr zz_prodtree_root(zz_prodtree_t T)
+{
+   return T->level[T->depth - 1];
+}
+
+/*
+   For each of the n positive integers in[i], set out[i] to the 
+   greatest common divisor of in[i] and the product of all the other
+   in[j]. This is Bernstein's batch gcd: a product tree is built,
+   the product of all the inputs is reduced modulo the squares of the
+   entries at each level of the tree in turn (a remainder tree), and
+   finally out[i] = gcd(in[i], (P mod in[i]^2)/in[i]). The total
+   cost is quasi-linear in the size of the input. Each out[i] may 
+   alias in[i].
+*/
+void zz_batch_gcd(zz_ptr * out, zz_srcptr * in, size_t n);
+
+/*
+   As for zz_batch_gcd, but with memory bounded by the size of the
+   product of all n inputs plus a product tree over at most chunk of
+   them. The inputs are processed in chunks of the given size. The 
+   remainder of the full product modulo the square of the product of
+   each chunk is computed and then streamed down the tree for that
+   chunk one level at a time. We require chunk > 0.
+*/
+void zz_batch_gcd_chunked(zz_ptr * out, zz_srcptr * in, 
+                                                 size_t n, size_t chunk);
+
+/**********************************************************************
+ 
+    Chinese remaindering
+
+**********************************************************************/
+
+/*
+   Precomputed data for Chinese remaindering with respect to a fixed
+   list of moduli m_i, namely a product tree of the moduli and the
+   inverses of M/m_i modulo m_i, where M is the product of all the
+   moduli.
+*/
+typedef struct
+{
+   zz_prodtree_t T;
+   zz_struct * inv; /* inv[i] = (M/m_i)^-1 mod m_i */
+   size_t n;
+} zz_crt_ctx_struct;
+
+typedef zz_crt_ctx_struct zz_crt_ctx_t[1];
+
+/*
+   Initialise a CRT context for the n moduli in mods. We require n > 0
+   and that the moduli are positive and pairwise coprime. The values
+   M/m_i mod m_i are found in quasi-linear time with a remainder tree
+   of the squares of the moduli.
+*/
+void zz_crt_ctx_init(zz_crt_ctx_t ctx, zz_srcptr * mods, size_t n);
+
+/*
+   Free the memory used by a CRT context.
+*/
+void zz_crt_ctx_clear(zz_crt_ctx_t ctx);
+
+/*
+   Set r to the unique value congruent to res[i] modulo m_i for each
+   of the moduli m_i in the given context. If sym is zero we have 
+   0 <= r < M, otherwise -M/2 < r <= M/2, where M is the product of
+   the moduli. The values r_i*(M/m_i)^-1 mod m_i are combined up the
+   product tree, so that the reconstruction takes quasi-linear time.
+   The residues res[i] may be any integers. The output r may alias
+   any of the residues.
+*/
+void zz_crt(zz_ptr r, zz_srcptr * res, zz_crt_ctx_t ctx, int sym);
+
+/**********************************************************************
+ 
+    Fixed base powering
+
+**********************************************************************/
+
+/*
+   Precomputed powers of a fixed base g modulo an odd modulus m for 
+   exponents of at most ebits bits, in Montgomery form. The exponent 
+   bits are arranged in h rows of a = ceil(ebits/h) columns and the 
+   columns are split into v blocks of b = ceil(a/v) (Lim and Lee). The
+   table holds, for each block k < v and each h bit index x, the 
+   product over the set bits j of x of g^(2^(j*a + k*b)).
+*/
+typedef struct zz_powm_fixed_ctx_struct
+{
+   zz_struct g;        /* the base, reduced mod m */
+   zz_struct m;        /* the modulus */
+   hensel_preinv1_t dinv;
+   bits_t ebits;
+   int h;
+   len_t a, b, v;
+   nn_t tab;           /* v*2^h entries of |m| words */
+} zz_powm_fixed_ctx_struct;
+
+typedef zz_powm_fixed_ctx_struct zz_powm_fixed_ctx_t[1];
+
+/*
+   The table size used by zz_powm_fixed_ctx_init when the budget is 0.
+*/
+#define ZZ_POWM_FIXED_BUDGET (WORD(1) << 20)
+
+/*
+   Initialise a context for powering g modulo the odd value m with 
+   exponents of at most ebits bits. The table takes at most budget 
+   bytes (ZZ_POWM_FIXED_BUDGET if budget is 0), except that a table of
+   two entries is always allowed. The shape is chosen to minimise the 
+   number of Montgomery products per powering. If the budget allows 
+   one block per column (v = a) there are no squarings at all, 
+   otherwise there are b - 1 squarings and at most a multiplications.
+*/
+void zz_powm_fixed_ctx_init(zz_powm_fixed_ctx_t ctx, zz_srcptr g, 
+                             zz_srcptr m, bits_t ebits, size_t budget);
+
+/*
+   Free the memory used by a fixed base powering context.
+*/
+void zz_powm_fixed_ctx_clear(zz_powm_fixed_ctx_t ctx);
+
+/*
+   Set r = g^e mod m, with 0 <= r < |m|, for the base and modulus of 
+   the given context. We require e >= 0. Exponents of more than ebits 
+   bits fall back to zz_powm.
+*/
+void zz_powm_fixed(zz_ptr r, zz_srcptr e, zz_powm_fixed_ctx_t ctx);
+
+/**********************************************************************
+ 
+    Multi-exponentiation
+
+**********************************************************************/
+
+/*
+   Set r = g[0]^e[0]*...*g[num - 1]^e[num - 1] mod m with 0 <= r < |m|.
+   We require e[i] >= 0 and m != 0. For odd m the bases are converted
+   to Montgomery form once and the squarings are shared by all terms.
+   Depending on which needs fewer products, either the terms are 
+   interleaved with a table of powers of each base (Straus) or, for 
+   each window, the bases are collected into buckets by digit and the
+   buckets combined with a running product (Pippenger). Even m falls
+   back to a product of zz_powm's. The output may alias any input.
+*/
+void zz_multi_powm(zz_ptr r, zz_srcptr * g, zz_srcptr * e, 
+                                              size_t num, zz_srcptr m);
+
+/**********************************************************************
+ 
+    Roots
+
+**********************************************************************/
+
+/*
+   Set s = floor(sqrt(a)) and r = a - s^2, using nn_sqrtrem. We require
+   a >= 0. The outputs s and r must be distinct, but may alias a.
+*/
+void zz_sqrtrem(zz_ptr s, zz_ptr r, zz_srcptr a);
+
+/*
+   Set s = floor(sqrt(a)). We require a >= 0. The output may alias a.
+*/
+void zz_sqrt(zz_ptr s, zz_srcptr a);
+
+/*
+   Set r to the k-th root of a, truncated towards zero, and set 
+   rem = a - r^k. The top half of the root is found recursively from
+   the top bits of a and the rest by a single Newton step at full 
+   precision with zz_pow and zz_div, followed by a correction of a 
+   unit or two, so that the cost is O(M(n)) for fixed k. Roots of at
+   most a word are seeded from a double. For k = 2 zz_sqrtrem is used.
+   We require k > 0, and k odd if a < 0. The outputs r and rem must be
+   distinct, but may alias a.
+*/
+void zz_rootrem(zz_ptr r, zz_ptr rem, zz_srcptr a, word_t k);
+
+/*
+   Set r to the k-th root of a, truncated towards zero. The 
+   requirements are as per zz_rootrem.
+*/
+void zz_root(zz_ptr r, zz_srcptr a, word_t k);
+
+/*
+   Return 1 if a is a perfect square, otherwise 0. Most non-squares are
+   rejected by their 2-adic valuation and by their residues modulo 
+   63, 65, 11 and a few more small primes, all found in a single 
+   nn_mod1_preinv pass, before nn_sqrtrem is called.
+*/
+int zz_is_square(zz_srcptr a);
+
+/*
+   If a = r^k for some k > 1, return the largest such k and, if r is
+   not NULL, set r to the root. Otherwise return 0. Prime exponents p
+   are tried in turn, filtered by the valuation of a and by residues
+   of a, so that most are rejected without taking a root. Small roots
+   are found from a double and checked modulo a word. For the other 
+   exponents, the residues of a modulo a prime q = 1 mod p for each p 
+   are found together by nn_multi_mod, so that a is not passed over 
+   once per exponent. Every k works for a = 0 and a = 1, and every odd
+   k for a = -1, in which case 2, resp. 3, is returned with r = a. The
+   output r may alias a.
+*/
+word_t zz_is_perfect_power(zz_ptr r, zz_srcptr a);
+
+/**********************************************************************
+ 
+    Primality testing
+
+**********************************************************************/
+
+/*
+   Return 0 if a is certainly composite (or less than 2), 1 if it is a 
+   probable prime and 2 if it is certainly prime, which is the case 
+   for every prime of one word (see n_is_prime). Larger values are 
+   trial divided by the odd primes dividing the residue modulus of 
+   zz_is_square, in a single nn_mod1_preinv pass, before the BPSW test:
+   a strong Fermat test to base 2 followed by a strong Lucas test with
+   Selfridge's parameters, both in Montgomery form. No composite is
+   known to pass.
+*/
+int zz_is_probab_prime(zz_srcptr a);
+
+/*
+   A segmented sieve of Eratosthenes over the odd values from an odd 
+   start. Each segment is a bit array, in which bit i stands for 
+   start + 2i and is set once a sieving prime divides that value. For 
+   each sieving prime we keep the bit index of its next odd multiple, 
+   so that moving to the next segment needs no divisions.
+*/
+typedef struct zz_sieve_struct
+{
+   zz_struct start;    /* the value of bit 0 of the segment, odd */
+   word_t * primes;    /* the odd sieving primes */
+   bits_t * offsets;   /* next bit marked by each prime */
+   long num;           /* number of sieving primes */
+   nn_t seg;           /* the segment */
+   bits_t bits;        /* bits per segment, a multiple of WORD_BITS */
+   bits_t pos;         /* the next bit of the segment to examine */
+} zz_sieve_struct;
+
+typedef zz_sieve_struct zz_sieve_t[1];
+
+/*
+   The largest segment used by zz_sieve_init, in bits. The default is
+   32kB, so that the segment stays in a level 1 cache.
+*/
+#define ZZ_SIEVE_BITS (WORD(1) << 18)
+
+/*
+   Initialise a sieve whose first candidate is the least odd value 
+   >= a, and which sieves by the odd primes up to bound (or a bound 
+   growing with the size of a, if bound is 0). Segments are about four
+   times the bit length of a, at most ZZ_SIEVE_BITS. The starting bit 
+   of each prime is found from a mod p, with one nn_mod1_preinv pass 
+   for each group of primes whose product fits in a word. We require 
+   a >= 0.
+*/
+void zz_sieve_init(zz_sieve_t S, zz_srcptr a, word_t bound);
+
+/*
+   Free the memory used by a sieve.
+*/
+void zz_sieve_clear(zz_sieve_t S);
+
+/*
+   Set r to the next candidate of the sieve which is a probable prime.
+   Only values left unmarked by the sieve are given to 
+   zz_is_probab_prime, and further segments are sieved as needed.
+*/
+void zz_sieve_next(zz_ptr r, zz_sieve_t S);
+
+/*
+   Set r to the least probable prime (see zz_is_probab_prime) greater 
+   than a, using zz_sieve. The output may alias a.
+*/
+void zz_nextprime(zz_ptr r, zz_srcptr a);
+
+/*
+   Set r to a random probable prime of exactly the given number of 
+   bits, i.e. the first one after a random value of that many bits,
+   retrying if there is none before 2^bits. Primes following large
+   gaps are therefore slightly favoured. We require bits >= 2.
+*/
+void zz_random_prime(zz_ptr r, bits_t bits, rand_t state);
+
 /**********************************************************************
  
     I/O
@@ -293,6 +652,12 @@ void zz_xgcd(zz_ptr g, zz_ptr s, zz_ptr t, zz_srcptr a, zz_srcptr b);
 */
 char * zz_get_str(zz_srcptr a);
 
+/*
+   As per zz_get_str, but large values are converted using up to the
+   given number of threads. See nn_get_str_threaded.
+*/
+char * zz_get_str_threaded(zz_srcptr a, long threads);
+
 /*
    Set the zz_t a to the integer whose decimal representation is
    given by the string str. If a negative value is required, the
@@ -300,6 +665,72 @@ char * zz_get_str(zz_srcptr a);
 */
 size_t zz_set_str(zz_t a, const char * str);
 
+/*
+   Return the number of digits of the absolute value of a in the given
+   base, or one more. See nn_sizeinbase.
+*/
+size_t zz_sizeinbase(zz_srcptr a, int base);
+
+/*
+   Set the zz_t a to the integer given by at most the first n characters 
+   of str, an optional '-' followed by decimal digits. The string need 
+   not be null terminated. The number of characters read is returned.
+   If no digit is found, a is set to 0 and 0 is returned, meaning that
+   nothing was parsed, and in particular a '-' is not consumed unless a
+   digit follows it.
+*/
+size_t zz_set_strn(zz_ptr a, const char * str, size_t n);
+
+/*
+   Read a decimal integer, optionally preceded by whitespace and a '-',
+   from the stream f into the zz_t a. The number of characters read is
+   returned, or 0 if no digits were found. The input is consumed in 
+   blocks of INP_STR_BLOCK_DIGITS digits, which are combined pairwise 
+   in a balanced tree, so only a block of characters is ever buffered.
+*/
+size_t zz_inp_str(zz_ptr a, FILE * f);
+
+/*
+   As per zz_get_str, but in the given base, where 2 <= base <= 62. 
+   See nn_get_str_base for the digits used.
+*/
+char * zz_get_str_base(zz_srcptr a, int base);
+
+/*
+   As per zz_set_str, but in the given base, where 2 <= base <= 62.
+   The number of characters read is returned, including any sign.
+*/
+size_t zz_set_str_base(zz_t a, const char * str, int base);
+
+/*
+   Write the decimal representation of the zz_t a to the stream f and
+   return the number of characters written. Large values are written
+   a block of digits at a time, without forming the whole string.
+*/
+size_t zz_out_str(FILE * f, zz_srcptr a);
+
+/*
+   Set r to the nonnegative integer given by count words of size bytes 
+   each at op. If order is 1 the most significant word comes first, if
+   it is -1 the least significant. The bytes in each word are most 
+   significant first if endian is 1, least significant first if it is
+   -1 and in the native byte order if it is 0. When the words are 
+   machine words, a straight copy or byte swap is used.
+*/
+void zz_import(zz_ptr r, size_t count, int order, size_t size, 
+                                              int endian, const void * op);
+
+/*
+   Write the absolute value of a to rop as words of size bytes in the
+   format described for zz_import, setting *countp to the number of 
+   words written. If rop is NULL, space is allocated with malloc and
+   the caller is responsible for freeing it. Otherwise rop must have 
+   room for (zz_sizeinbase(a, 2) + 8*size - 1)/(8*size) words. The 
+   value 0 is written as no words. Returns rop.
+*/
+void * zz_export(void * rop, size_t * countp, int order, size_t size, 
+                                                  int endian, zz_srcptr a);
+
 /*
    Print the decimal representation of the zz_t a to stdout. No
    newline character is output.